@@ -0,0 +1,122 @@
+// Model-rate (16 kHz) to host-rate upsampling: juce::WindowedSincInterpolator
+// against PolyphaseResampler at each quality tier.
+//
+// For each host rate, renders kHops hops of a 1 kHz sine and reports the
+// time per hop and the level of the first image (16 kHz - 1 kHz) relative to
+// the tone. Build with -DDDSP_BUILD_BENCHMARKS=ON.
+
+#include "DDSPTypes.h"
+#include "PolyphaseResampler.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace {
+
+constexpr int kHops = 20000;
+constexpr int kWarmupHops = 50;
+constexpr double kToneHz = 1000.0;
+constexpr double kPi = 3.14159265358979323846;
+
+// Magnitude of one frequency bin (Goertzel)
+double toneLevel(const std::vector<float>& signal, double frequency, double sample_rate) {
+    const double coeff = 2.0 * std::cos(2.0 * kPi * frequency / sample_rate);
+    double s1 = 0.0;
+    double s2 = 0.0;
+    for (float x : signal) {
+        const double s0 = x + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+    const double power = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+    return std::sqrt(std::max(power, 0.0)) / static_cast<double>(signal.size());
+}
+
+struct Result {
+    double ns_per_hop = 0.0;
+    double image_db = 0.0;
+};
+
+// process_hop(input, output) converts one model hop to host_hop samples
+Result run(double host_rate, int host_hop, const std::function<void(const float*, float*)>& process_hop) {
+    std::vector<float> input(ddsp::kModelHopSize);
+    std::vector<float> output(static_cast<size_t>(host_hop));
+    std::vector<float> capture;
+    capture.reserve(static_cast<size_t>(host_hop) * 200);
+
+    double phase = 0.0;
+    const double increment = 2.0 * kPi * kToneHz / ddsp::kModelSampleRate_Hz;
+    auto fillInput = [&]() {
+        for (float& x : input) {
+            x = static_cast<float>(0.5 * std::sin(phase));
+            phase = std::fmod(phase + increment, 2.0 * kPi);
+        }
+    };
+
+    for (int hop = 0; hop < kWarmupHops; ++hop) {
+        fillInput();
+        process_hop(input.data(), output.data());
+    }
+    for (int hop = 0; hop < 200; ++hop) {
+        fillInput();
+        process_hop(input.data(), output.data());
+        capture.insert(capture.end(), output.begin(), output.end());
+    }
+
+    double elapsed_ns = 0.0;
+    for (int hop = 0; hop < kHops; ++hop) {
+        fillInput();
+        const auto start = std::chrono::steady_clock::now();
+        process_hop(input.data(), output.data());
+        elapsed_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    Result result;
+    result.ns_per_hop = elapsed_ns / kHops;
+    const double tone = toneLevel(capture, kToneHz, host_rate);
+    const double image = toneLevel(capture, ddsp::kModelSampleRate_Hz - kToneHz, host_rate);
+    result.image_db = 20.0 * std::log10(std::max(image, 1e-12) / std::max(tone, 1e-12));
+    return result;
+}
+
+void report(const char* name, const Result& result) {
+    const double hop_ns = 1e9 * ddsp::kModelHopSize / ddsp::kModelSampleRate_Hz;
+    std::printf("  %-18s %9.0f ns/hop  %8.0fx realtime  image %7.1f dB\n",
+                name, result.ns_per_hop, hop_ns / result.ns_per_hop, result.image_db);
+}
+
+} // namespace
+
+int main() {
+    using Quality = ddsp::PolyphaseResampler::Quality;
+
+    for (double host_rate : {44100.0, 48000.0, 96000.0}) {
+        const int host_hop = static_cast<int>(host_rate * ddsp::kModelHopSize / ddsp::kModelSampleRate_Hz);
+        std::printf("16000 -> %.0f Hz (%d samples per hop)\n", host_rate, host_hop);
+
+        juce::WindowedSincInterpolator interpolator;
+        report("WindowedSinc", run(host_rate, host_hop, [&](const float* in, float* out) {
+            interpolator.process(ddsp::kModelSampleRate_Hz / host_rate, in, out, host_hop);
+        }));
+
+        const std::pair<const char*, Quality> tiers[] = {
+            {"Polyphase Low", Quality::Low},
+            {"Polyphase Medium", Quality::Medium},
+            {"Polyphase High", Quality::High},
+        };
+        for (const auto& [name, quality] : tiers) {
+            ddsp::PolyphaseResampler resampler;
+            if (!resampler.prepare(ddsp::kModelSampleRate_Hz, host_rate, ddsp::kModelHopSize, quality)) {
+                std::printf("  %-18s unsupported ratio\n", name);
+                continue;
+            }
+            report(name, run(host_rate, host_hop, [&](const float* in, float* out) {
+                resampler.process(in, ddsp::kModelHopSize, out);
+            }));
+        }
+    }
+    return 0;
+}
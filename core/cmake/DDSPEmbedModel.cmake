@@ -0,0 +1,72 @@
+# ==============================================================================
+# ddsp_embed_model(<target> <model_file> <symbol>)
+#
+# Compiles <model_file> (e.g. a .tflite) into <target> as a read-only,
+# 16-byte aligned byte array, so the model loads without file I/O:
+#
+#   #include "<symbol>.h"
+#   pipeline.loadModelFromMemory(<symbol>, <symbol>_size);
+#
+# The generated header declares
+#   extern "C" const unsigned char <symbol>[];
+#   extern "C" const size_t <symbol>_size;
+# and is added to the target's private include path. The array is
+# regenerated when the model file changes.
+# ==============================================================================
+
+if(CMAKE_SCRIPT_MODE_FILE)
+    # Generator, run at build time by the custom command below
+    file(READ "${MODEL_FILE}" model_hex HEX)
+    string(LENGTH "${model_hex}" model_hex_length)
+    math(EXPR model_size "${model_hex_length} / 2")
+
+    # 16 bytes per line, then 0x-prefix each byte
+    string(REGEX REPLACE "(................................)" "\\1\n" model_hex "${model_hex}")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," model_hex "${model_hex}")
+
+    file(WRITE "${SOURCE_FILE}"
+        "// Generated by ddsp_embed_model() from ${MODEL_FILE}; do not edit\n"
+        "#include <cstddef>\n\n"
+        "extern \"C\" alignas(16) const unsigned char ${SYMBOL}[] = {\n"
+        "${model_hex}\n"
+        "};\n\n"
+        "extern \"C\" const size_t ${SYMBOL}_size = ${model_size};\n")
+
+    file(WRITE "${HEADER_FILE}"
+        "// Generated by ddsp_embed_model(); do not edit\n"
+        "#pragma once\n\n"
+        "#include <cstddef>\n\n"
+        "extern \"C\" const unsigned char ${SYMBOL}[];\n"
+        "extern \"C\" const size_t ${SYMBOL}_size;\n")
+    return()
+endif()
+
+set(DDSP_EMBED_MODEL_SCRIPT "${CMAKE_CURRENT_LIST_FILE}" CACHE INTERNAL "ddsp_embed_model generator")
+
+function(ddsp_embed_model target model_file symbol)
+    get_filename_component(model_file "${model_file}" ABSOLUTE)
+    if(NOT EXISTS "${model_file}")
+        message(FATAL_ERROR "ddsp_embed_model: model not found: ${model_file}")
+    endif()
+
+    set(out_dir "${CMAKE_CURRENT_BINARY_DIR}/ddsp_embedded")
+    set(source_file "${out_dir}/${symbol}.cpp")
+    set(header_file "${out_dir}/${symbol}.h")
+    file(MAKE_DIRECTORY "${out_dir}")
+
+    add_custom_command(
+        OUTPUT "${source_file}" "${header_file}"
+        COMMAND ${CMAKE_COMMAND}
+            -DMODEL_FILE=${model_file}
+            -DSYMBOL=${symbol}
+            -DSOURCE_FILE=${source_file}
+            -DHEADER_FILE=${header_file}
+            -P "${DDSP_EMBED_MODEL_SCRIPT}"
+        DEPENDS "${model_file}" "${DDSP_EMBED_MODEL_SCRIPT}"
+        COMMENT "Embedding ${model_file} as ${symbol}"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE "${source_file}" "${header_file}")
+    target_include_directories(${target} PRIVATE "${out_dir}")
+endfunction()
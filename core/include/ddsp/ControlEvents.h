@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ddsp {
+
+/**
+ * Timestamped control change for InferencePipeline::pushControlEvent()
+ *
+ * sample_time is a position on the pipeline's output timeline (see
+ * InferencePipeline::getHostSamplePosition()): the event takes effect at
+ * that sample of the rendered audio. Only the fields named in flags are
+ * applied, so one event can carry f0 and loudness together.
+ */
+struct ControlEvent {
+    static constexpr uint32_t kF0 = 1u << 0;
+    static constexpr uint32_t kLoudness = 1u << 1;
+    static constexpr uint32_t kNoteOn = 1u << 2;  // Start a new note (implies kF0 | kLoudness)
+
+    int64_t sample_time = 0;
+    float f0_hz = 0.0f;
+    float loudness_norm = 0.0f;
+    uint32_t flags = 0;
+
+    static ControlEvent f0(int64_t sample_time, float f0_hz) {
+        return {sample_time, f0_hz, 0.0f, kF0};
+    }
+
+    static ControlEvent loudness(int64_t sample_time, float loudness_norm) {
+        return {sample_time, 0.0f, loudness_norm, kLoudness};
+    }
+
+    static ControlEvent controls(int64_t sample_time, float f0_hz, float loudness_norm) {
+        return {sample_time, f0_hz, loudness_norm, kF0 | kLoudness};
+    }
+
+    static ControlEvent noteOn(int64_t sample_time, float f0_hz, float loudness_norm) {
+        return {sample_time, f0_hz, loudness_norm, kF0 | kLoudness | kNoteOn};
+    }
+};
+
+/**
+ * Sequence lock around a small trivially copyable value
+ *
+ * Readers never block and always see a value written by one store():
+ * they retry if a writer was active while they copied. Writers serialize
+ * among themselves on the odd sequence count. The value is kept in
+ * relaxed atomic words, so concurrent copies are not data races.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock needs a trivially copyable value");
+
+public:
+    explicit SeqLock(const T& value = T()) {
+        writeWords(value);
+    }
+
+    T load() const {
+        for (;;) {
+            const uint32_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1u) {
+                continue;  // Writer active
+            }
+            T value = readWords();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                return value;
+            }
+        }
+    }
+
+    void store(const T& value) {
+        update([&value](T& current) { current = value; });
+    }
+
+    /**
+     * Read-modify-write under the writer lock
+     */
+    template <typename Fn>
+    void update(Fn&& fn) {
+        uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        while ((sequence & 1u) ||
+               !sequence_.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+            sequence = sequence_.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        T value = readWords();
+        fn(value);
+        writeWords(value);
+
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> sequence_{0};
+    std::array<std::atomic<uint32_t>, kWords> words_{};
+
+    T readWords() const {
+        uint32_t raw[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            raw[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        T value;
+        std::memcpy(&value, raw, sizeof(T));
+        return value;
+    }
+
+    void writeWords(const T& value) {
+        uint32_t raw[kWords] = {};
+        std::memcpy(raw, &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(raw[i], std::memory_order_relaxed);
+        }
+    }
+};
+
+} // namespace ddsp
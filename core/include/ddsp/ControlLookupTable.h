@@ -0,0 +1,90 @@
+#pragma once
+
+#include "IControlModel.h"
+#include <string>
+#include <vector>
+
+namespace ddsp {
+
+/**
+ * Steady-state synthesis controls on a (f0_norm, loudness_norm) grid
+ *
+ * build() sweeps a uniform grid through a control model, running each
+ * cell from a cold state to convergence, and stores amplitude, harmonics
+ * and noise magnitudes. lookup() bilinearly interpolates the table, so
+ * a voice can be rendered with no neural inference. The table captures
+ * the model's sustained response only; onset transients are lost.
+ *
+ * File format (little-endian): "DDSPCLUT", uint32 version, uint32 pitch
+ * steps, loudness steps, harmonics, noise amps, uint64 source model content hash
+ * (FNV-1a), then the float table.
+ *
+ * Thread-safety: NOT thread-safe; lookup() is const.
+ */
+class ControlLookupTable {
+public:
+    struct Config {
+        int pitch_steps = 64;            // Grid points over f0_norm [0, 1] (>= 2)
+        int loudness_steps = 16;         // Grid points over loudness_norm [0, 1] (>= 2)
+        int max_settle_hops = 64;        // Upper bound per cell
+        float settle_threshold = 1e-5f;  // Max |state delta| treated as converged
+    };
+
+    /**
+     * Difference between the table and live steady-state inference
+     */
+    struct Quality {
+        int probes = 0;                   // Off-grid points compared
+        float max_abs_error = 0.0f;       // Over all control values
+        float rms_error = 0.0f;           // Over all control values
+        float max_amplitude_error_db = 0.0f;
+    };
+
+    ControlLookupTable() = default;
+
+    /**
+     * Sweep the grid through the model; leaves the model reset
+     */
+    bool build(IControlModel& model, const Config& config);
+
+    /**
+     * Serialise / deserialise the table
+     * @param source_model_hash Content hash of the model file the table came from
+     */
+    bool save(const std::string& path, uint64_t source_model_hash) const;
+    bool load(const std::string& path);
+
+    /**
+     * Interpolated controls; does not allocate
+     * Leaves output.f0_hz untouched.
+     */
+    void lookup(float f0_norm, float loudness_norm, SynthesisControls& output) const;
+
+    /**
+     * Compare against live inference at cell centres (worst case for
+     * bilinear interpolation); leaves the model reset
+     */
+    Quality measureQuality(IControlModel& reference, int probes_per_axis = 16) const;
+
+    bool empty() const { return values_.empty(); }
+    int pitchSteps() const { return pitch_steps_; }
+    int loudnessSteps() const { return loudness_steps_; }
+    uint64_t sourceModelHash() const { return source_model_hash_; }
+    size_t memoryBytes() const { return values_.size() * sizeof(float); }
+
+private:
+    static constexpr int kValuesPerCell = kAmplitudeSize + kHarmonicsSize + kNoiseAmpsSize;
+
+    int pitch_steps_ = 0;
+    int loudness_steps_ = 0;
+    uint64_t source_model_hash_ = 0;
+
+    // [pitch][loudness][amplitude, harmonics..., noise...]
+    std::vector<float> values_;
+
+    const float* cell(int pitch, int loudness) const {
+        return values_.data() + (static_cast<size_t>(pitch) * loudness_steps_ + loudness) * kValuesPerCell;
+    }
+};
+
+} // namespace ddsp
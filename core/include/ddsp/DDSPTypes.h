@@ -1,9 +1,13 @@
 #pragma once
 
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <string>
 #include <string_view>
+#include <type_traits>
 
 namespace ddsp {
 
@@ -26,11 +30,15 @@ constexpr int kLoudnessSize = 1;
 constexpr int kF0Size = 1;
 constexpr int kGruModelStateSize = 512;
 
+// Capacity of fixed-size control frames (largest supported model shape)
+constexpr int kMaxHarmonicsSize = 128;
+constexpr int kMaxNoiseAmpsSize = 129;
+
 // Pitch range (MIDI note 0 to 127)
 constexpr float kPitchRangeMin_Hz = 8.18f;      // MIDI note 0
 constexpr float kPitchRangeMax_Hz = 12543.84f;  // MIDI note 127
 
-// Ring buffer size
+// Upper bound on ring buffer sizes (pipelines size theirs from block size and latency mode)
 constexpr int kRingBufferSize = 61440;
 
 // ============================================================================
@@ -51,6 +59,32 @@ inline constexpr std::string_view kOutputTensorName_State = "StatefulPartitioned
 constexpr int kNumPredictControlsInputTensors = 3;
 constexpr int kNumPredictControlsOutputTensors = 4;
 
+/**
+ * Tensor names and sizes of a loaded control model
+ *
+ * Defaults describe the ddsp-vst export the constants above come from.
+ * Backends that read shapes from the model (TFLite) overwrite them at load;
+ * the synthesizers are sized from num_harmonics / num_noise_amps.
+ */
+struct ModelSignature {
+    int num_harmonics = kHarmonicsSize;
+    int num_noise_amps = kNoiseAmpsSize;
+    int state_size = kGruModelStateSize;
+
+    std::string f0_input = std::string(kInputTensorName_F0);
+    std::string loudness_input = std::string(kInputTensorName_Loudness);
+    std::string state_input = std::string(kInputTensorName_State);
+    std::string amplitude_output = std::string(kOutputTensorName_Amplitude);
+    std::string harmonics_output = std::string(kOutputTensorName_Harmonics);
+    std::string noise_output = std::string(kOutputTensorName_NoiseAmps);
+    std::string state_output = std::string(kOutputTensorName_State);
+
+    bool hasDefaultShape() const {
+        return num_harmonics == kHarmonicsSize && num_noise_amps == kNoiseAmpsSize &&
+               state_size == kGruModelStateSize;
+    }
+};
+
 // ============================================================================
 // Data Structures
 // ============================================================================
@@ -78,6 +112,35 @@ struct SynthesisControls {
 
     SynthesisControls() = default;
 
+    SynthesisControls(int num_harmonics, int num_noise_amps)
+        : noiseAmps(static_cast<size_t>(num_noise_amps), 0.0f)
+        , harmonics(static_cast<size_t>(num_harmonics), 0.0f)
+    {}
+
+    /**
+     * Match a model signature (allocates only when the sizes change)
+     */
+    void resize(int num_harmonics, int num_noise_amps) {
+        harmonics.resize(static_cast<size_t>(num_harmonics), 0.0f);
+        noiseAmps.resize(static_cast<size_t>(num_noise_amps), 0.0f);
+    }
+
+    /**
+     * Copy values from controls of any shape (allocates only when the sizes change)
+     */
+    void copyFrom(const SynthesisControls& other) {
+        resize(static_cast<int>(other.harmonics.size()), static_cast<int>(other.noiseAmps.size()));
+        amplitude = other.amplitude;
+        f0_hz = other.f0_hz;
+        std::copy(other.harmonics.begin(), other.harmonics.end(), harmonics.begin());
+        std::copy(other.noiseAmps.begin(), other.noiseAmps.end(), noiseAmps.begin());
+    }
+
+    bool matches(const ModelSignature& signature) const {
+        return harmonics.size() == static_cast<size_t>(signature.num_harmonics) &&
+               noiseAmps.size() == static_cast<size_t>(signature.num_noise_amps);
+    }
+
     void clear() {
         amplitude = 0.0f;
         f0_hz = 0.0f;
@@ -86,6 +149,76 @@ struct SynthesisControls {
     }
 };
 
+/**
+ * Fixed-size, trivially copyable synthesis controls
+ *
+ * Same content as SynthesisControls for models up to kMaxHarmonicsSize /
+ * kMaxNoiseAmpsSize, without heap storage: safe to memcpy through SPSC
+ * queues, shared memory or batched output buffers. The arrays start on
+ * cache lines; entries past num_harmonics / num_noise_amps are unused.
+ * Readers from another process should check isValid() first.
+ */
+struct alignas(64) SynthesisControlFrame {
+    static constexpr uint32_t kVersion = 1;
+
+    // Flag bits
+    static constexpr uint32_t kNoteOn = 1u << 0;  // First hop of a new note
+
+    uint32_t version = kVersion;
+    uint32_t flags = 0;
+    int32_t num_harmonics = 0;
+    int32_t num_noise_amps = 0;
+    float amplitude = 0.0f;
+    float f0_hz = 0.0f;
+    uint64_t sequence = 0;                      // Producer-defined (e.g. hop index)
+    alignas(64) std::array<float, kMaxHarmonicsSize> harmonics{};
+    alignas(64) std::array<float, kMaxNoiseAmpsSize> noise_amps{};
+
+    static bool fits(int harmonics_size, int noise_amps_size) {
+        return harmonics_size >= 0 && harmonics_size <= kMaxHarmonicsSize &&
+               noise_amps_size >= 0 && noise_amps_size <= kMaxNoiseAmpsSize;
+    }
+
+    bool isValid() const {
+        return version == kVersion && fits(num_harmonics, num_noise_amps);
+    }
+
+    /**
+     * Copy from the vector form
+     * @return false (frame untouched) if the controls exceed the capacity
+     */
+    bool assign(const SynthesisControls& controls) {
+        const int h = static_cast<int>(controls.harmonics.size());
+        const int n = static_cast<int>(controls.noiseAmps.size());
+        if (!fits(h, n)) {
+            return false;
+        }
+        num_harmonics = h;
+        num_noise_amps = n;
+        amplitude = controls.amplitude;
+        f0_hz = controls.f0_hz;
+        std::copy(controls.harmonics.begin(), controls.harmonics.end(), harmonics.begin());
+        std::copy(controls.noiseAmps.begin(), controls.noiseAmps.end(), noise_amps.begin());
+        return true;
+    }
+
+    /**
+     * Copy into the vector form (allocates only when the sizes change)
+     */
+    void copyTo(SynthesisControls& controls) const {
+        controls.resize(num_harmonics, num_noise_amps);
+        controls.amplitude = amplitude;
+        controls.f0_hz = f0_hz;
+        std::copy(harmonics.begin(), harmonics.begin() + num_harmonics, controls.harmonics.begin());
+        std::copy(noise_amps.begin(), noise_amps.begin() + num_noise_amps, controls.noiseAmps.begin());
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<SynthesisControlFrame>,
+              "SynthesisControlFrame must be memcpy-able");
+static_assert(std::is_standard_layout_v<SynthesisControlFrame>,
+              "SynthesisControlFrame must have a stable layout");
+
 /**
  * Configuration for DDSP synthesis engine
  */
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "DDSPTypes.h"
+#include <cstddef>
 #include <vector>
 #include <optional>
 
@@ -13,7 +14,8 @@ namespace ddsp {
  * fundamental frequency and per-harmonic amplitude distributions.
  *
  * Features:
- * - 60 harmonics at model sample rate (16kHz)
+ * - Any harmonic count at model sample rate (16kHz); 60 and 64 (the
+ *   shipped model shapes) use compile-time specialised kernels
  * - Midway interpolation (anti-swooping)
  * - Nyquist filtering (removes harmonics >= 8kHz)
  * - Harmonic normalization (sum to 1, scale by amplitude)
@@ -22,6 +24,16 @@ namespace ddsp {
  */
 class HarmonicSynthesizer {
 public:
+    /**
+     * Phase and interpolation memory carried between frames
+     */
+    struct State {
+        float phase = 0.0f;
+        std::optional<float> f0;
+        float amplitude = 0.0f;
+        std::vector<float> harmonic_distribution;
+    };
+
     /**
      * Constructor
      * @param num_harmonics Number of harmonics (default 60)
@@ -50,11 +62,31 @@ public:
         float f0_hz
     );
 
+    /**
+     * Advance the phase exactly as render() would, without synthesizing
+     * (reconstructs the phase at any frame from the f0 sequence alone)
+     */
+    void advancePhase(float f0_hz);
+
     /**
      * Reset internal state (phases, previous values)
      */
     void reset();
 
+    /**
+     * Snapshot/restore phase state
+     * Does not allocate once state.harmonic_distribution has num_harmonics entries.
+     */
+    void getState(State& state) const;
+    void setState(const State& state);
+
+    int getNumHarmonics() const { return num_harmonics_; }
+
+    /**
+     * Heap used by state and working buffers, in bytes
+     */
+    size_t getMemoryBytes() const;
+
 private:
     int num_harmonics_;
     int num_output_samples_;
@@ -65,13 +97,13 @@ private:
     std::optional<float> previous_f0_;
     float previous_amplitude_;
     std::vector<float> previous_harmonic_distribution_;
+    std::vector<float> start_harmonic_distribution_;  // Ramp start of the current frame
 
     // Working buffers
     std::vector<float> harmonic_series_;            // [1, 2, 3, ..., num_harmonics]
-    std::vector<float> frame_frequencies_;          // Frequencies for current frame
     std::vector<float> frequency_envelope_;         // Interpolated f0 [num_output_samples]
     std::vector<float> phases_;                     // Phase accumulator [num_output_samples]
-    std::vector<std::vector<float>> harmonic_amplitudes_; // [num_harmonics][num_output_samples]
+    std::vector<float> ramp_;                       // Midway lerp positions [num_output_samples / 2]
     std::vector<float> render_buffer_;              // Output buffer
 
     /**
@@ -101,6 +133,11 @@ private:
         float last
     );
 
+    /**
+     * Integrate frequency_envelope_ into phases_ and carry the phase over
+     */
+    void integratePhase();
+
     /**
      * Perform additive synthesis
      */
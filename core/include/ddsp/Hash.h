@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ddsp {
+
+static constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+static constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+/**
+ * FNV-1a over a byte range; pass a previous result as hash to chain ranges
+ * Not cryptographic - only used to tell models and inputs apart.
+ */
+inline uint64_t fnv1a(const void* data, size_t size, uint64_t hash = kFnvOffset) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+} // namespace ddsp
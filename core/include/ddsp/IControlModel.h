@@ -0,0 +1,300 @@
+#pragma once
+
+#include "DDSPTypes.h"
+#include "ModelBlob.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ddsp {
+
+/**
+ * Available inference backends for control prediction
+ *
+ * Default resolves to the first backend compiled into this build
+ * (TFLite, then ONNX Runtime, then the native engine).
+ */
+enum class ControlModelBackend {
+    Default,
+    TFLite,       // TensorFlow Lite C API (.tflite), XNNPACK/CoreML delegates
+    OnnxRuntime,  // ONNX Runtime C++ API (.onnx)
+    Native,       // Built-in C++ GRU decoder (.ddspw weight file)
+    Stub,         // Deterministic model for tests, no file required
+    LookupTable   // Precomputed steady-state control table (.lut), no neural inference
+};
+
+/**
+ * Options for IControlModel::loadModel
+ */
+struct ModelLoadOptions {
+    int num_threads = 2;                  // Threads for inference
+
+    // Tensor names sidecar (TFLite backend, see readModelSignature)
+    std::string metadata_path;            // "" = <model_path>.meta if it exists
+
+    // Delegate/thread autotuning (TFLite backend)
+    bool autotune = false;                // Sweep delegate x threads, keep best p99
+    std::string autotune_cache_path;      // Result cache ("" = <model_path>.autotune)
+    int autotune_warmup_invocations = 5;  // Discarded invocations per candidate
+    int autotune_timed_invocations = 50;  // Measured invocations per candidate
+
+    // Cold-start mitigation
+    int warmup_invocations = 8;           // Invocations run (and discarded) during load
+    bool xnnpack_weight_cache = true;     // Persist packed XNNPACK weights beside the model
+    std::string xnnpack_weight_cache_path; // "" = <model_path>.xnnpack_cache
+
+    // Control lookup table (LookupTable backend)
+    ControlModelBackend lut_source_backend = ControlModelBackend::Default; // Model swept to build the table
+    std::string lut_path;                 // "" = <model_path>.lut
+    int lut_pitch_steps = 64;             // Grid points over f0_norm [0, 1]
+    int lut_loudness_steps = 16;          // Grid points over loudness_norm [0, 1]
+
+    // Prefix-memoised inference (OfflineRenderer only, see MemoizedControlModel)
+    size_t inference_cache_bytes = 0;     // > 0 wraps the model in a cache of this budget
+    int inference_cache_quantisation = 4096; // Input levels over [0, 1]
+};
+
+/**
+ * Startup timeline recorded by loadModel (milliseconds)
+ *
+ * Stages a backend does not have stay at zero.
+ */
+struct StartupProfile {
+    double file_read_ms = 0.0;           // Reading model file into memory
+    double autotune_ms = 0.0;            // Delegate/thread sweep (0 when cached)
+    double delegate_ms = 0.0;            // Creating the delegate
+    double interpreter_create_ms = 0.0;  // Interpreter/session creation (applies delegates)
+    double allocate_ms = 0.0;            // Tensor allocation
+    double warmup_ms = 0.0;              // Warm-up invocations
+    double total_ms = 0.0;               // Whole loadModel call
+};
+
+/**
+ * Per-backend inference timing, updated on every call()
+ */
+struct InferenceTiming {
+    uint64_t num_calls = 0;      // Successful + failed invocations
+    uint64_t num_failures = 0;   // Invocations that returned false
+    double last_us = 0.0;        // Duration of the most recent call
+    double mean_us = 0.0;        // Running mean over all calls
+    double max_us = 0.0;         // Worst call since last reset
+};
+
+/**
+ * Why the most recent call() failed
+ *
+ * Backends record this instead of logging, since call() runs on the
+ * render thread.
+ */
+enum class InferenceError {
+    None,
+    NotReady,       // No model loaded, or output shape mismatch
+    InputTensors,   // Could not write the input tensors
+    Invoke,         // Backend inference failed
+    OutputTensors,  // Could not read the output tensors
+    Unknown         // invoke() failed without a reason
+};
+
+/**
+ * Interface for DDSP control prediction backends
+ *
+ * Takes normalized audio features (f0, loudness) and predicts
+ * synthesis controls (amplitude, harmonics, noise magnitudes),
+ * carrying the recurrent state between frames.
+ *
+ * call() is non-virtual: it times the backend's invoke() so every
+ * backend reports comparable numbers.
+ *
+ * Thread-safety: NOT thread-safe. Use from single thread only.
+ */
+class IControlModel {
+public:
+    virtual ~IControlModel() = default;
+
+    /**
+     * Load model from file
+     * @param model_path Path to the backend's model file
+     * @param options Threading and tuning options
+     * @return true if successful
+     */
+    virtual bool loadModel(const std::string& model_path, const ModelLoadOptions& options) = 0;
+
+    /**
+     * Load model from shared, read-only model bytes
+     *
+     * Backends that parse in place keep the blob alive for the model's
+     * lifetime; the default reloads from blob->path().
+     * @return true if successful
+     */
+    virtual bool loadModelFromBlob(std::shared_ptr<const ModelBlob> blob, const ModelLoadOptions& options);
+
+    /**
+     * Load model from caller-owned bytes (e.g. an embedded resource)
+     *
+     * No copy is made: the bytes must outlive the model. Side caches
+     * (autotune, XNNPACK weights) need explicit paths in options.
+     * Supported by backends that override loadModelFromBlob (TFLite, ONNX Runtime).
+     * @return true if successful
+     */
+    bool loadModelFromMemory(const void* data, size_t size, const ModelLoadOptions& options) {
+        return loadModelFromBlob(ModelBlob::wrap(data, size), options);
+    }
+
+    /**
+     * Load model from file with default options
+     * @param model_path Path to the backend's model file
+     * @param num_threads Number of threads for inference
+     * @return true if successful
+     */
+    bool loadModel(const std::string& model_path, int num_threads = 2) {
+        ModelLoadOptions options;
+        options.num_threads = num_threads;
+        return loadModel(model_path, options);
+    }
+
+    /**
+     * Run inference and record timing
+     *
+     * @param input Audio features (f0_norm, loudness_norm must be set)
+     * @param output Synthesis controls (amplitude, harmonics, noiseAmps)
+     * @return true if inference successful
+     */
+    bool call(const AudioFeatures& input, SynthesisControls& output);
+
+    /**
+     * Reset model state (clears recurrent state)
+     */
+    virtual void reset() = 0;
+
+    /**
+     * Check if model is loaded and ready
+     */
+    virtual bool isLoaded() const = 0;
+
+    /**
+     * Size of the recurrent state in floats (0 before load)
+     */
+    virtual size_t stateSize() const = 0;
+
+    /**
+     * Copy the recurrent state out / in (snapshot and restore)
+     * @param size Must equal stateSize()
+     * @return false on size mismatch
+     */
+    virtual bool getState(float* dst, size_t size) const = 0;
+    virtual bool setState(const float* src, size_t size) = 0;
+
+    /**
+     * Hand leased inference threads back to the InferenceScheduler while
+     * the model sits idle (e.g. cached in ModelRegistry)
+     * Backends without per-model threads ignore this.
+     */
+    virtual void releaseThreads() {}
+
+    /**
+     * Lease inference threads again after releaseThreads(), before the
+     * next call()
+     * @return false if the model could not be made ready again
+     */
+    virtual bool acquireThreads() { return true; }
+
+    /**
+     * Backend implemented by this model
+     */
+    virtual ControlModelBackend backend() const = 0;
+
+    /**
+     * Tensor names and sizes of the loaded model
+     * Output passed to call() is resized to match on first use.
+     */
+    virtual const ModelSignature& getSignature() const { return signature_; }
+
+    /**
+     * Timing statistics since load (or last resetTiming())
+     */
+    const InferenceTiming& getTiming() const { return timing_; }
+    void resetTiming() { timing_ = InferenceTiming{}; }
+
+    /**
+     * Timeline of the most recent loadModel call
+     */
+    const StartupProfile& getStartupProfile() const { return startup_profile_; }
+
+    /**
+     * Reason for the most recent failed call() (None after a success)
+     * Readable from any thread.
+     */
+    InferenceError getLastError() const { return last_error_.load(std::memory_order_relaxed); }
+
+protected:
+    /**
+     * Backend-specific inference, called by call()
+     */
+    virtual bool invoke(const AudioFeatures& input, SynthesisControls& output) = 0;
+
+    /**
+     * Run discarded invocations so caches, lazy allocations and packed
+     * weights are hot before the first real frame, then reset state.
+     * Records startup_profile_.warmup_ms.
+     */
+    void warmUp(int invocations);
+
+    /**
+     * Record why invoke() is about to return false (no allocation, no I/O)
+     */
+    void setLastError(InferenceError error) { last_error_.store(error, std::memory_order_relaxed); }
+
+    StartupProfile startup_profile_;
+    ModelSignature signature_;
+
+private:
+    InferenceTiming timing_;
+    std::atomic<InferenceError> last_error_{InferenceError::None};
+};
+
+/**
+ * Feed constant inputs until the recurrent state stops changing
+ *
+ * Starts from the model's current state (reset() first for a cold start).
+ * @param max_hops Upper bound on invocations
+ * @param threshold Max |state delta| between hops treated as converged
+ * @return Number of invocations run, or -1 if inference failed
+ */
+int runToSteadyState(IControlModel& model, const AudioFeatures& input, SynthesisControls& output,
+                     int max_hops, float threshold);
+
+/**
+ * Read tensor names from a model metadata sidecar
+ *
+ * One "key = value" per line, '#' starts a comment. Keys are the
+ * ModelSignature name fields (f0_input, loudness_input, state_input,
+ * amplitude_output, harmonics_output, noise_output, state_output);
+ * unknown keys are ignored and missing keys keep their value. Sizes are
+ * always taken from the model itself.
+ * @return false if the file cannot be opened
+ */
+bool readModelSignature(const std::string& path, ModelSignature& signature);
+
+/**
+ * Create a control model for the given backend
+ * @return nullptr if the backend is not compiled into this build
+ */
+std::unique_ptr<IControlModel> createControlModel(ControlModelBackend backend = ControlModelBackend::Default);
+
+/**
+ * Check whether a backend is compiled into this build
+ */
+bool isControlModelBackendAvailable(ControlModelBackend backend);
+
+/**
+ * Resolve ControlModelBackend::Default to a concrete backend
+ */
+ControlModelBackend resolveControlModelBackend(ControlModelBackend backend);
+
+/**
+ * Human-readable backend name (for logs and benchmarks)
+ */
+const char* controlModelBackendName(ControlModelBackend backend);
+
+} // namespace ddsp
@@ -2,9 +2,15 @@
 
 #include "DDSPTypes.h"
 #include "InputUtils.h"
-#include "PredictControlsModel.h"
+#include "IControlModel.h"
 #include "HarmonicSynthesizer.h"
 #include "NoiseSynthesizer.h"
+#include "WarmStateCache.h"
+#include "SteadyStateDetector.h"
+#include "ControlEvents.h"
+#include "PolyphaseResampler.h"
+#include "RealtimeSignal.h"
+#include <array>
 #include <memory>
 #include <vector>
 #include <atomic>
@@ -15,6 +21,8 @@
 
 namespace ddsp {
 
+class RenderPool;
+
 /**
  * Main DDSP inference and synthesis pipeline
  *
@@ -30,9 +38,100 @@ namespace ddsp {
  * - Background inference thread
  * - Lock-free ring buffers
  * - Synth mode (MIDI/parameter input, no audio input)
+ * - Background model loading with hop-aligned hot swap
+ * - Pre-warmed GRU states for note onsets
+ * - Steady-state inference skipping for sustained notes
+ * - Reduced-rate inference with per-hop control interpolation
+ * - Optional pipelined mode (inference and synthesis on separate threads)
  */
 class InferencePipeline {
 public:
+    /**
+     * State of the most recent loadModelAsync request
+     */
+    enum class ModelLoadState {
+        Idle,     // No asynchronous load requested
+        Loading,  // Background thread is preparing the model
+        Pending,  // Loaded, waiting for the next hop boundary
+        Swapped,  // Now rendering with the new model
+        Failed    // Load failed; previous model (if any) keeps rendering
+    };
+
+    /**
+     * Trade-off between output latency and underrun safety
+     */
+    enum class LatencyMode {
+        Minimum,   // Render ahead one host block; no prefill
+        Balanced,  // One host block plus one hop (default)
+        Safe       // Block plus two hops, a hop of output silence and the legacy input frame prefill
+    };
+
+    /**
+     * Render scheduler counters since startTimer() / reset
+     *
+     * The scheduler renders whatever keeps the output FIFO at its
+     * watermark, so the audio it rendered, less what is still buffered,
+     * is what the host consumed. Its difference from elapsed wall time is
+     * the audio clock's drift, which a fixed timer would have let
+     * accumulate as underruns or overflow.
+     */
+    struct RenderSchedulerStats {
+        uint64_t wakeups = 0;         // Scheduler wake-ups
+        uint64_t hops = 0;            // Hops rendered by the scheduler
+        uint64_t catch_up_hops = 0;   // Extra hops rendered to reach the watermark
+        uint64_t idle_wakeups = 0;    // Wake-ups with the FIFO already at the watermark
+        uint64_t underruns = 0;       // Wake-ups that found the output FIFO empty
+        int fill_samples = 0;         // Output FIFO level after the last wake-up
+        double corrected_drift_ms = 0.0;  // Consumed audio (rendered - fill growth) minus wall time
+        double drift_ppm = 0.0;           // corrected_drift_ms relative to wall time
+    };
+
+    /**
+     * Latest control parameters, read and written as one unit
+     */
+    struct ControlValues {
+        float f0_hz = 440.0f;
+        float loudness_norm = 0.5f;
+        float pitch_shift_semitones = 0.0f;
+        float harmonic_gain = 1.0f;
+        float noise_gain = 1.0f;
+        uint32_t f0_revision = 0;        // Bumped by each f0 write
+        uint32_t loudness_revision = 0;  // Bumped by each loudness write
+    };
+
+    /**
+     * Snapshot of everything that carries over between hops
+     */
+    struct VoiceState {
+        std::vector<float> model_state;
+        HarmonicSynthesizer::State harmonic;
+    };
+
+    /**
+     * Bytes held by one pipeline, per component
+     *
+     * Buffers are sized at prepareToPlay(); the model itself (weights,
+     * interpreter) and the shared resampler table are not part of total().
+     */
+    struct MemoryUsage {
+        size_t object = 0;           // sizeof(InferencePipeline): event queue, control frames, atomics
+        size_t output_fifo = 0;      // Sized from the latency mode and block size
+        size_t input_path = 0;       // Input FIFO and frame buffers (audio input only)
+        size_t working_buffers = 0;  // Synthesis hop and resampled hop
+        size_t controls = 0;         // Control vectors and note-on snapshot
+        size_t resampler = 0;        // Resampler history
+        size_t harmonic_synth = 0;
+        size_t noise_synth = 0;
+        size_t model_state = 0;      // Recurrent state of the loaded model
+        size_t warm_cache = 0;       // Warm state cache, if enabled
+        size_t shared_resampler_table = 0;  // Shared by pipelines at the same rate and quality
+
+        size_t total() const {
+            return object + output_fifo + input_path + working_buffers + controls + resampler +
+                   harmonic_synth + noise_synth + model_state + warm_cache;
+        }
+    };
+
     explicit InferencePipeline();
     ~InferencePipeline();
 
@@ -47,24 +146,178 @@ public:
     void releaseResources();
 
     /**
-     * Load TFLite model
+     * Load control model
+     * @param model_path Path to model file for the selected backend
+     * @param num_threads Number of threads for inference
+     * @param backend Inference backend (Default = best compiled-in backend)
      */
-    bool loadModel(const std::string& model_path, int num_threads = 2);
+    bool loadModel(const std::string& model_path, int num_threads = 2,
+                   ControlModelBackend backend = ControlModelBackend::Default);
+
+    /**
+     * Load control model with explicit load options (e.g. autotune)
+     */
+    bool loadModel(const std::string& model_path, const ModelLoadOptions& options,
+                   ControlModelBackend backend = ControlModelBackend::Default);
+
+    /**
+     * Load control model from caller-owned bytes (e.g. a model embedded
+     * with ddsp_embed_model()); no file I/O, the bytes must outlive the model
+     */
+    bool loadModelFromMemory(const void* data, size_t size,
+                             const ModelLoadOptions& options = ModelLoadOptions(),
+                             ControlModelBackend backend = ControlModelBackend::Default);
+
+    /**
+     * Take ownership of an already loaded model (e.g. from ModelRegistry)
+     * Synchronous like loadModel(); call with the render thread stopped.
+     * The synthesizers are resized to the model's signature.
+     */
+    bool adoptModel(std::unique_ptr<IControlModel> model);
+
+    /**
+     * Hand the current model back (e.g. to ModelRegistry::release())
+     * Synchronous; the pipeline is not ready afterwards.
+     */
+    std::unique_ptr<IControlModel> releaseModel();
+
+    /**
+     * Load a model on a background thread and hot-swap it in
+     *
+     * Returns immediately. The current model (if any) keeps rendering; the
+     * new one is swapped in atomically at the next hop boundary. With
+     * crossfade_hops > 0 both models run for that many hops while the
+     * synthesis controls fade from the old model to the new one.
+     * A new request waits for an in-flight load to finish first.
+     * A model with a different harmonic/noise shape gets its synthesizers
+     * built on the loader thread and is swapped in without a crossfade.
+     */
+    void loadModelAsync(const std::string& model_path,
+                        const ModelLoadOptions& options = ModelLoadOptions(),
+                        ControlModelBackend backend = ControlModelBackend::Default,
+                        int crossfade_hops = 0);
+
+    /**
+     * loadModelAsync() from model bytes (ModelBlob::wrap / copyOf / mapFile)
+     */
+    void loadModelAsync(std::shared_ptr<const ModelBlob> blob,
+                        const ModelLoadOptions& options = ModelLoadOptions(),
+                        ControlModelBackend backend = ControlModelBackend::Default,
+                        int crossfade_hops = 0);
+
+    /**
+     * State of the most recent asynchronous load
+     */
+    ModelLoadState getModelLoadState() const { return load_state_.load(std::memory_order_acquire); }
 
     /**
      * Start/stop background inference thread
+     *
+     * The render thread wakes every interval_ms on absolute deadlines and
+     * renders as many hops as needed to bring the output FIFO up to the
+     * target watermark, so it follows the host's consumption instead of
+     * its own clock.
      */
     void startTimer(int interval_ms = 20);
     void stopTimer();
 
+    /**
+     * Output FIFO level (user-rate samples) the render thread keeps ahead
+     * Set before prepareToPlay() to size the FIFO for more than the mode needs.
+     * @param samples 0 = derive from the latency mode (default)
+     */
+    void setTargetFillSamples(int samples);
+    int getTargetFillSamples() const;
+
+    /**
+     * Select render-ahead depth and prefill
+     * The watermark changes immediately; prefill applies at the next reset().
+     * The output FIFO is sized for the mode (and any larger target fill) at
+     * prepareToPlay(), so a deeper mode is capped until the next prepare.
+     */
+    void setLatencyMode(LatencyMode mode);
+    LatencyMode getLatencyMode() const { return latency_mode_.load(std::memory_order_relaxed); }
+
+    /**
+     * Current end-to-end latency in host-rate samples
+     *
+     * Time from a parameter change to its first audible sample: rendered
+     * samples still queued for the host, control frames queued by the
+     * pipelined inference stage, the ramp delay of reduced-rate inference
+     * and the output resampler's delay.
+     */
+    int getLatencySamples() const;
+
+    /**
+     * Output resampler quality (16/32/64 taps per phase)
+     * Applies at the next prepareToPlay(). Host rates whose hop is not a
+     * whole number of samples fall back to juce::WindowedSincInterpolator.
+     */
+    void setResamplerQuality(PolyphaseResampler::Quality quality) { resampler_quality_ = quality; }
+    PolyphaseResampler::Quality getResamplerQuality() const { return resampler_quality_; }
+
+    /**
+     * True if the model-to-host conversion uses the polyphase resampler
+     */
+    bool isUsingPolyphaseResampler() const { return output_resampler_.isPrepared(); }
+
+    /**
+     * Render scheduler drift and fill statistics
+     */
+    RenderSchedulerStats getRenderSchedulerStats() const;
+    void resetRenderSchedulerStats();
+
+    /**
+     * Run inference and synthesis on separate threads
+     *
+     * An inference thread produces the controls for hop t+1 while the
+     * render thread synthesizes and resamples hop t. The stages hand off
+     * through a lock-free queue of preallocated control frames, which adds
+     * up to one hop of control latency. Set before startTimer();
+     * triggerRender() always runs both stages serially.
+     */
+    void setPipelinedRendering(bool enabled);
+    bool isPipelinedRendering() const { return pipelined_.load(std::memory_order_relaxed); }
+
+    /**
+     * Render synchronously inside getNextBlock() (no background thread)
+     *
+     * getNextBlock() renders as many hops as the request needs on the
+     * calling thread and carries only the leftover samples over, so output
+     * latency drops to under one hop. Enabling stops the timer thread;
+     * startTimer() is a no-op while pull mode is on.
+     */
+    void setPullRendering(bool enabled);
+    bool isPullRendering() const { return pull_mode_.load(std::memory_order_relaxed); }
+
+    /**
+     * Render on a shared RenderPool instead of a dedicated thread
+     *
+     * startTimer() then registers with the pool and stopTimer() leaves it.
+     * Pooled pipelines render serially (pipelined mode is ignored).
+     * Set before startTimer(); nullptr restores the dedicated thread.
+     */
+    void setRenderPool(RenderPool* pool);
+    RenderPool* getRenderPool() const { return render_pool_; }
+
+    /**
+     * Allocate the audio input path (input FIFO and model-rate frame buffers)
+     * Synth mode never reads input audio, so it is off by default and costs
+     * no memory. Applies at the next prepareToPlay().
+     */
+    void setAudioInputEnabled(bool enabled) { audio_input_enabled_ = enabled; }
+    bool isAudioInputEnabled() const { return audio_input_enabled_; }
+
     /**
      * Process block (called from audio thread)
-     * In synth mode, this enqueues the current parameters for processing
+     * In synth mode, this enqueues the current parameters for processing;
+     * input audio is queued only with the audio input path enabled
      */
     void processBlock(juce::AudioBuffer<float>& buffer, int num_samples);
 
     /**
      * Get next synthesized audio block (called from audio thread)
+     * In pull mode the missing hops are rendered here first.
      * @param output Output buffer to fill
      * @param num_samples Number of samples requested
      * @return Number of samples actually written
@@ -72,16 +325,108 @@ public:
     int getNextBlock(float* output, int num_samples);
 
     int getNumReadySamples() const;
+
+    /**
+     * Render one hop on the calling thread
+     * Ignored while the timer thread is running or in pull mode, where the
+     * timer thread or getNextBlock() owns the render state.
+     */
     void triggerRender();
 
     /**
      * Set external control parameters (for synth mode)
-     * All parameters are atomic for thread safety
+     * Thread-safe; the renderer samples all values together once per hop.
      */
     void setF0Hz(float f0_hz);
     void setLoudnessNorm(float loudness_norm);
     void setLoudnessDb(float loudness_db);
 
+    /**
+     * Set f0 and loudness together, so no hop sees one without the other
+     */
+    void setControls(float f0_hz, float loudness_norm);
+
+    /**
+     * Consistent snapshot of the latest control values (seqlock, wait-free
+     * unless a writer is mid-update)
+     */
+    ControlValues getControlValues() const { return controls_.load(); }
+
+    /**
+     * Queue a timestamped control change (single producer, e.g. the audio thread)
+     *
+     * The event applies at its sample_time on the output timeline. Each hop
+     * averages f0/loudness over the time each value was in effect within
+     * the hop; a note-on restarts the hop at its own values. Late events
+     * apply at the next hop. Applied values hold for later hops until the
+     * next parameter write; getControlValues() does not report them.
+     * @return false if the queue is full
+     */
+    bool pushControlEvent(const ControlEvent& event);
+
+    /**
+     * Output samples handed to the host since reset(), i.e. the timeline
+     * position of the next sample getNextBlock() returns
+     */
+    int64_t getHostSamplePosition() const { return host_position_.load(std::memory_order_acquire); }
+
+    /**
+     * Start a new note at the next hop
+     *
+     * Sets f0/loudness and, if the warm state cache is enabled, restores the
+     * converged GRU state of the nearest cached (pitch, loudness) cell so
+     * the first hop of the note is already settled. The harmonic
+     * synthesizer keeps its phase but does not glide from the previous f0.
+     */
+    void noteOn(float f0_hz, float loudness_norm);
+
+    /**
+     * Build a warm state cache on every subsequent model load
+     * Takes effect at the next loadModel()/loadModelAsync().
+     */
+    void enableWarmStateCache(const WarmStateCache::Config& config = WarmStateCache::Config());
+    void disableWarmStateCache();
+
+    /**
+     * Reuse the last controls while inputs, GRU state and outputs are constant
+     * Configure before startTimer(); disabling is safe at any time.
+     */
+    void enableSteadyStateSkipping(const SteadyStateDetector::Config& config = SteadyStateDetector::Config());
+    void disableSteadyStateSkipping();
+
+    /**
+     * Skip-rate counters (hops, skipped hops, estimated inference time saved)
+     */
+    SteadyStateDetector::Stats getSteadyStateStats() const;
+    void resetSteadyStateStats();
+
+    /**
+     * Run the model only every `hops` hops (1 = every hop, 20 ms)
+     *
+     * The GRU advances exactly once per inference, always on the same
+     * decimated grid, and the synthesizers still render every hop: the
+     * harmonic/noise controls ramp linearly from the previous inference
+     * to the newest one over the interval, while f0 follows every hop.
+     * This adds up to (hops - 1) hops of control latency; note-ons snap.
+     * Safe to call while rendering; takes effect at the next inference.
+     */
+    void setInferenceInterval(int hops);
+    int getInferenceInterval() const { return inference_interval_.load(std::memory_order_relaxed); }
+
+    /**
+     * Model invocations per second of rendered audio since reset()
+     * 50 Hz when inferring every hop; lower with skipping or an interval.
+     */
+    double getEffectiveInferenceRateHz() const;
+
+    /**
+     * Snapshot/restore model and synthesizer state
+     * Call with the render thread stopped (or from the render thread).
+     * @return false if no model is loaded or the state size does not match
+     */
+    bool captureVoiceState(VoiceState& state) const;
+    bool restoreVoiceState(const VoiceState& state);
+
     /**
      * Set pitch shift in semitones
      */
@@ -101,7 +446,38 @@ public:
     /**
      * Check if model is loaded
      */
-    bool isReady() const { return model_ready_; }
+    bool isReady() const { return model_ready_.load(std::memory_order_acquire); }
+
+    /**
+     * Backend of the loaded model (Default if none loaded)
+     */
+    ControlModelBackend getBackend() const;
+
+    /**
+     * Hops whose inference failed (rendered nothing) since construction
+     */
+    uint64_t getInferenceFailureCount() const { return inference_failures_.load(std::memory_order_relaxed); }
+
+    /**
+     * Backend's reason for the most recent failed hop (None if none failed)
+     */
+    InferenceError getLastInferenceError() const { return last_inference_error_.load(std::memory_order_relaxed); }
+
+    /**
+     * Inference timing reported by the loaded backend
+     */
+    InferenceTiming getInferenceTiming() const;
+
+    /**
+     * Startup timeline of the last model load (cold-start tracking)
+     */
+    StartupProfile getStartupProfile() const;
+
+    /**
+     * Per-component memory of this pipeline (control thread)
+     * Call with the render thread stopped or no model swap pending.
+     */
+    MemoryUsage memoryUsage() const;
 
     /**
      * Get current pitch (for UI feedback)
@@ -119,14 +495,16 @@ private:
     int samples_per_block_;
     int user_frame_size_;
     int user_hop_size_;
-    bool model_ready_;
+    int output_capacity_;        // Output FIFO size (usable samples + 1)
+    bool audio_input_enabled_;
+    std::atomic<bool> model_ready_;
 
     // Core components
-    std::unique_ptr<PredictControlsModel> model_;
+    std::unique_ptr<IControlModel> model_;
     std::unique_ptr<HarmonicSynthesizer> harmonic_synth_;
     std::unique_ptr<NoiseSynthesizer> noise_synth_;
 
-    // Ring buffers (using JUCE AbstractFifo)
+    // Ring buffers (using JUCE AbstractFifo); the input side only with audio input
     std::unique_ptr<juce::AbstractFifo> input_fifo_;
     std::unique_ptr<juce::AbstractFifo> output_fifo_;
     juce::AudioBuffer<float> input_ring_buffer_;
@@ -134,20 +512,33 @@ private:
 
     // Resampling (JUCE interpolators)
     juce::WindowedSincInterpolator input_interpolator_;
-    juce::WindowedSincInterpolator output_interpolator_;
+    juce::WindowedSincInterpolator output_interpolator_;  // Fallback for non-rational ratios
+    PolyphaseResampler output_resampler_;                 // Model rate -> host rate
+    PolyphaseResampler::Quality resampler_quality_ = PolyphaseResampler::Quality::Medium;
 
-    // Working buffers
+    // Working buffers (the two input frames only with audio input)
     juce::AudioBuffer<float> model_input_buffer_;           // User sample rate frame
     juce::AudioBuffer<float> resampled_model_input_buffer_; // 16kHz frame (1024)
     juce::AudioBuffer<float> synthesis_buffer_;              // 16kHz hop (320)
     juce::AudioBuffer<float> resampled_model_output_buffer_; // User sample rate hop
 
-    // Control parameters (atomic for thread safety)
-    std::atomic<float> f0_hz_;
-    std::atomic<float> loudness_norm_;
-    std::atomic<float> pitch_shift_semitones_;
-    std::atomic<float> harmonic_gain_;
-    std::atomic<float> noise_gain_;
+    // Control parameters (one seqlock so a hop never sees a torn update)
+    SeqLock<ControlValues> controls_;
+
+    // Timestamped control events (SPSC: producer thread -> inference stage)
+    static constexpr int kEventQueueSize = 256;
+    juce::AbstractFifo event_fifo_;
+    std::array<ControlEvent, kEventQueueSize> events_;
+    int64_t infer_position_;              // Output-timeline start of the next inferred hop
+    // Values left by the last applied event (inference stage only). They stand
+    // in for controls_ until a write bumps its revision, so controls_ keeps a
+    // single writer on the control side.
+    float event_f0_hz_;
+    float event_loudness_norm_;
+    uint32_t event_f0_revision_;
+    uint32_t event_loudness_revision_;
+    bool event_values_valid_;
+    std::atomic<int64_t> host_position_;  // Output samples read by the host
 
     // Current state for UI feedback
     std::atomic<float> current_pitch_;
@@ -155,27 +546,259 @@ private:
 
     // Current control data
     AudioFeatures predict_controls_input_;
-    SynthesisControls synthesis_input_;
+    SynthesisControls model_controls_;   // Model output, kept across hops
+    SynthesisControls synthesis_input_;  // Gained copy consumed by the synthesizers
+
+    // Steady-state inference skipping
+    std::atomic<bool> steady_state_enabled_;
+    SteadyStateDetector steady_state_;
+
+    // Reduced-rate inference
+    std::atomic<int> inference_interval_;
+    SynthesisControls ramp_start_controls_;  // Controls at the previous inference
+    int hops_until_inference_;
+    int ramp_length_;
+    int ramp_position_;
+    bool snap_controls_;                     // Next inference is applied without a ramp
+    std::atomic<uint64_t> rendered_hops_;
+    std::atomic<uint64_t> model_invocations_;
+
+    /**
+     * Render state sized for a hot-swapped model's shape, built on the
+     * loader thread. The inference stage swaps its half in at the model
+     * swap, the synthesis stage its half when the first hop of the new
+     * shape reaches it; the object then holds the old state and is retired.
+     */
+    struct ShapeState {
+        // Inference stage
+        SynthesisControls model_controls;
+        SynthesisControls synthesis_input;
+        SynthesisControls ramp_start_controls;
+        SynthesisControls fading_controls;
+        SteadyStateDetector steady_state;
+        // Synthesis stage
+        std::unique_ptr<HarmonicSynthesizer> harmonic_synth;
+        std::unique_ptr<NoiseSynthesizer> noise_synth;
+        HarmonicSynthesizer::State note_on_harmonic_state;
+        SynthesisControls queued_controls;
+    };
 
-    // Background thread
+    /**
+     * Everything a background load hands to the render thread, published
+     * through one pointer so the swap sees all of it or none. After the
+     * swap it carries the outgoing warm cache (and an unused shape state)
+     * back for retirement.
+     */
+    struct PendingModel {
+        std::unique_ptr<IControlModel> model;
+        std::unique_ptr<WarmStateCache> warm_cache;
+        std::unique_ptr<ShapeState> shape;
+        int crossfade_hops = 0;
+    };
+
+    // Asynchronous model loading / hot swap
+    std::thread loader_thread_;
+    std::atomic<ModelLoadState> load_state_;
+    std::atomic<PendingModel*> pending_;          // Loaded, not yet swapped in (owned)
+    std::atomic<ShapeState*> staged_shape_;       // Waiting for the synthesis stage (owned)
+    // Swapped-out models and load leftovers, freed by the control or timer
+    // thread (owned). One load retires at most two models, one PendingModel
+    // and one shape state, and startAsyncLoad() frees the slots before the
+    // next, so the render thread never deletes.
+    static constexpr int kRetiredSlots = 4;
+    std::array<std::atomic<IControlModel*>, kRetiredSlots> retired_models_{};
+    std::array<std::atomic<PendingModel*>, kRetiredSlots> retired_pending_{};
+    std::array<std::atomic<ShapeState*>, kRetiredSlots> retired_shapes_{};
+    std::unique_ptr<IControlModel> fading_model_; // Previous model during crossfade
+    SynthesisControls fading_controls_;
+    int crossfade_hops_;
+    int crossfade_position_;
+
+    // Pre-warmed note-onset states (built per model, swapped with it)
+    bool warm_cache_enabled_;
+    WarmStateCache::Config warm_cache_config_;
+    std::unique_ptr<WarmStateCache> warm_cache_;
+    std::atomic<bool> note_on_pending_;
+    HarmonicSynthesizer::State note_on_harmonic_state_;
+
+    // Pipelined rendering: inference stage -> control queue -> synthesis stage
+    static constexpr int kControlQueueSize = 2;  // One frame in flight (AbstractFifo keeps a slot free)
+    std::atomic<bool> pipelined_;
+    juce::AbstractFifo control_fifo_;
+    std::array<SynthesisControlFrame, kControlQueueSize> control_frames_;
+    SynthesisControls queued_controls_;          // Render-thread copy of a dequeued frame
+    RealtimeSignal controls_ready_;              // Lock-free signal(), callable in the realtime scope
+    RealtimeSignal controls_consumed_;
+
+    // Render scheduler (FIFO watermark tracking)
+    static constexpr int kMaxHopsPerWakeup = 16;
+    std::atomic<int> target_fill_samples_;     // 0 = from latency_mode_, capped by output_capacity_
+    std::atomic<LatencyMode> latency_mode_;
+    std::atomic<uint64_t> scheduler_wakeups_;
+    std::atomic<uint64_t> scheduler_hops_;
+    std::atomic<uint64_t> scheduler_catch_up_hops_;
+    std::atomic<uint64_t> scheduler_idle_wakeups_;
+    std::atomic<uint64_t> scheduler_underruns_;
+    std::atomic<int> scheduler_fill_samples_;
+    std::atomic<int64_t> scheduler_start_ns_;   // steady_clock, 0 = not started
+    std::atomic<int> scheduler_start_fill_;     // Output FIFO level at scheduler_start_ns_
+
+    // Pull mode: getNextBlock() renders on the audio thread
+    std::atomic<bool> pull_mode_;
+
+    // Shared render workers (nullptr = dedicated render thread)
+    RenderPool* render_pool_;
+    RenderPool* active_pool_;   // Pool we are registered with while running
+
+    // Failed hops (counted instead of logged on the render path)
+    std::atomic<uint64_t> inference_failures_;
+    std::atomic<InferenceError> last_inference_error_;
+
+    // Background threads
     std::atomic<bool> should_run_;
     std::unique_ptr<std::thread> render_thread_;
+    std::unique_ptr<std::thread> inference_thread_;  // Pipelined mode only
 
     /**
-     * Background rendering loop
+     * Background rendering loop (watermark-driven, absolute deadlines)
      */
     void renderLoop(int interval_ms);
 
     /**
-     * Single render iteration
+     * One scheduler wake-up: render hops up to the FIFO watermark
+     * Called by renderLoop() and by RenderPool workers.
+     * @return Hops rendered
+     */
+    int renderToWatermark(int interval_ms);
+    friend class RenderPool;
+
+    /**
+     * Render one hop with whichever stage layout is active
+     */
+    void renderHop(int timeout_ms);
+
+    /**
+     * Pipelined inference stage: keep the control queue full
+     */
+    void inferenceLoop(int interval_ms);
+
+    /**
+     * Single render iteration (both stages, serially)
      * Called from background thread
      */
     void render();
 
+    /**
+     * Inference stage of one hop: model swap, parameters, note-on and
+     * gained controls into synthesis_input_
+     * @return false if no model is ready or inference failed
+     */
+    bool inferHop(bool& note_on);
+
+    /**
+     * Synthesis stage of one hop: synthesize, resample, push to output
+     */
+    void synthesizeHop(SynthesisControls& controls, bool note_on);
+
+    /**
+     * Infer one hop into the next free control frame (inference thread)
+     */
+    bool pushControlFrame();
+
+    /**
+     * Synthesize the oldest queued control frame (render thread)
+     */
+    void renderQueuedHop(int timeout_ms);
+
+    /**
+     * Swap in a pending model at a hop boundary (render thread)
+     */
+    void swapPendingModel();
+
+    /**
+     * Synthesis stage: take the synthesizers staged by a shape-changing swap
+     */
+    void adoptStagedShape();
+
+    /**
+     * Apply queued events due in the next hop to f0/loudness (inference stage)
+     * @param values Parameters the hop started from (their revisions tag the event values)
+     * @return true if an event landed in this hop
+     */
+    bool applyControlEvents(float& f0_hz, float& loudness_norm, bool& note_on, const ControlValues& values);
+
+    /**
+     * Restore the warm state for a new note (inference stage)
+     */
+    void applyNoteOn(float f0_hz, float loudness_norm);
+
+    /**
+     * Shared body of the loadModelAsync() overloads (blob null = load model_path)
+     */
+    void startAsyncLoad(const std::string& model_path, std::shared_ptr<const ModelBlob> blob,
+                        const ModelLoadOptions& options, ControlModelBackend backend, int crossfade_hops);
+
+    /**
+     * Size synthesizers and control buffers for a model (control thread)
+     * @return false if the synthesizers cannot render the model's shape
+     */
+    bool configureForModel(const IControlModel& model);
+
+    /**
+     * Whether the synthesizers can render a model's shape (logs if not)
+     */
+    static bool isSupportedShape(const ModelSignature& signature);
+
+    /**
+     * Render state for a model of another shape (loader thread)
+     */
+    static std::unique_ptr<ShapeState> buildShapeState(const IControlModel& model);
+
+    /**
+     * Build a warm state cache for a freshly loaded model if enabled
+     */
+    static std::unique_ptr<WarmStateCache> buildWarmStateCache(
+        IControlModel& model, bool enabled, const WarmStateCache::Config& config);
+
+    /**
+     * Produce synthesis_input_ for this hop, inferring every Nth hop
+     */
+    bool updateControls();
+
+    /**
+     * Produce model_controls_ (inference or steady-state reuse)
+     */
+    bool computeControls();
+
+    /**
+     * Run model inference into model_controls_, crossfading if needed
+     */
+    bool runInference();
+
+    /**
+     * Hand a swapped-out model to the control thread for deletion
+     */
+    void retireModel(std::unique_ptr<IControlModel> model);
+
+    /**
+     * Free models retired by the render thread and wait for the loader
+     */
+    void collectRetiredModels();
+
+    /**
+     * Free retired models without waiting for the loader (any thread)
+     */
+    void freeRetiredModels();
+
+    /**
+     * Watermark for a latency mode at the prepared block and hop size
+     */
+    int watermarkForMode(LatencyMode mode) const;
+
     /**
      * Push samples to input ring buffer
      */
-    void pushToInputBuffer(const juce::AudioBuffer<float>& buffer);
+    void pushToInputBuffer(const juce::AudioBuffer<float>& buffer, int num_samples);
 
     /**
      * Pop samples from output ring buffer
@@ -186,6 +809,11 @@ private:
      * Zero-pad input buffer for latency compensation
      */
     void zeroPadInputBuffer();
+
+    /**
+     * Push silence into the output FIFO (Safe latency mode)
+     */
+    void prefillOutputBuffer(int num_samples);
 };
 
 } // namespace ddsp
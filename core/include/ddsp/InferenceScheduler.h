@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+namespace ddsp {
+
+/**
+ * How many threads a single model invocation may use
+ */
+enum class ParallelismPolicy {
+    SingleThreaded,  // Always run on the calling thread (best for many voices)
+    Capped,          // min(requested, max_threads_per_invocation), within the budget
+    Requested        // Honour ModelLoadOptions::num_threads, within the budget (default)
+};
+
+/**
+ * Process-wide inference thread budget
+ *
+ * Each interpreter otherwise creates its own worker threads, so many
+ * voices oversubscribe the machine. Backends lease worker threads here
+ * when they build an interpreter and return them when it is destroyed:
+ * the sum of leased worker threads never exceeds the budget, and a model
+ * that finds the budget exhausted runs on its calling thread only.
+ *
+ * TFLite/XNNPACK threads are fixed per interpreter, so the budget is
+ * enforced at load time; changing it affects later loads only. The ONNX
+ * Runtime backend instead shares one global intra-op pool, sized from
+ * the budget when the first ONNX model loads.
+ *
+ * Thread-safety: all methods are thread-safe.
+ */
+class InferenceScheduler {
+public:
+    /**
+     * Worker threads held by one interpreter; returned on destruction
+     */
+    class ThreadLease {
+    public:
+        ThreadLease() = default;
+        ~ThreadLease() { release(); }
+
+        ThreadLease(ThreadLease&& other) noexcept;
+        ThreadLease& operator=(ThreadLease&& other) noexcept;
+        ThreadLease(const ThreadLease&) = delete;
+        ThreadLease& operator=(const ThreadLease&) = delete;
+
+        /**
+         * Threads the interpreter may use, including the calling thread
+         */
+        int threads() const { return worker_threads_ + 1; }
+
+        void release();
+
+    private:
+        friend class InferenceScheduler;
+        InferenceScheduler* scheduler_ = nullptr;
+        int worker_threads_ = 0;
+    };
+
+    struct Stats {
+        int thread_budget = 0;        // Worker threads allowed process-wide
+        int threads_in_use = 0;       // Worker threads currently leased
+        int active_leases = 0;        // Interpreters holding a lease
+        uint64_t clamped_leases = 0;  // Leases granted fewer threads than requested
+    };
+
+    static InferenceScheduler& instance();
+
+    /**
+     * Lease threads for a new interpreter
+     * @param requested_threads Threads the backend asked for (incl. calling thread)
+     */
+    ThreadLease acquire(int requested_threads);
+
+    /**
+     * Worker threads allowed across all interpreters (excludes calling threads)
+     */
+    void setThreadBudget(int worker_threads);
+    int getThreadBudget() const;
+
+    void setParallelismPolicy(ParallelismPolicy policy, int max_threads_per_invocation = 2);
+    ParallelismPolicy getParallelismPolicy() const;
+
+    /**
+     * Most threads the policy grants one interpreter (0 = no limit but the budget)
+     */
+    int getMaxThreadsPerInvocation() const;
+
+    Stats getStats() const;
+
+private:
+    InferenceScheduler();
+
+    void release(int worker_threads);
+
+    mutable std::mutex mutex_;
+    int thread_budget_;
+    int threads_in_use_;
+    int active_leases_;
+    uint64_t clamped_leases_;
+    ParallelismPolicy policy_;
+    int max_threads_per_invocation_;
+};
+
+} // namespace ddsp
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "IControlModel.h"
+#include "ControlLookupTable.h"
+
+namespace ddsp {
+
+/**
+ * Control model backed by a precomputed lookup table
+ *
+ * Runs no neural inference: each call is a bilinear lookup in a
+ * ControlLookupTable. loadModel() accepts either a .lut file directly or a
+ * model file for options.lut_source_backend; in the latter case the table
+ * next to the model (options.lut_path, default <model_path>.lut) is reused
+ * when it matches the model's content hash and grid, otherwise the model is
+ * loaded, swept and the table written back beside it. A model that cannot be
+ * read (e.g. the Stub backend's empty path) is swept on every load.
+ *
+ * The model has no recurrent state (stateSize() == 0).
+ *
+ * Thread-safety: NOT thread-safe. Use from single thread only.
+ */
+class LutControlModel : public IControlModel {
+public:
+    LutControlModel();
+    ~LutControlModel() override = default;
+
+    bool loadModel(const std::string& model_path, const ModelLoadOptions& options) override;
+    using IControlModel::loadModel;
+
+    void reset() override {}
+    size_t stateSize() const override { return 0; }
+    bool getState(float*, size_t size) const override { return size == 0; }
+    bool setState(const float*, size_t size) override { return size == 0; }
+    bool isLoaded() const override { return model_loaded_; }
+    ControlModelBackend backend() const override { return ControlModelBackend::LookupTable; }
+
+    const ControlLookupTable& getTable() const { return table_; }
+
+protected:
+    bool invoke(const AudioFeatures& input, SynthesisControls& output) override;
+
+private:
+    bool model_loaded_;
+    ControlLookupTable table_;
+};
+
+} // namespace ddsp
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "IControlModel.h"
+#include <atomic>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace ddsp {
+
+/**
+ * Prefix-memoised control model for offline and batch rendering
+ *
+ * Wraps another backend. The GRU is deterministic given its inputs, so
+ * the controls and state after a hop are a function of the input sequence
+ * since the last reset. Each call extends a 64-bit hash chain with the
+ * quantised (f0_norm, loudness_norm) input; a hit returns the stored
+ * controls and GRU state without running the inner model, so repeated
+ * phrases and shared prefixes cost nothing after the first render.
+ *
+ * Inputs are quantised before they reach the inner model, so a hit is
+ * exactly what a miss would have computed. setState() re-seeds the chain
+ * from the state contents.
+ *
+ * Entries are evicted least-recently-used to stay within the byte budget.
+ * Inserting allocates: use for offline rendering, not the real-time path.
+ *
+ * Thread-safety: NOT thread-safe, except getCacheStats().
+ */
+class MemoizedControlModel : public IControlModel {
+public:
+    struct CacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+
+        double hitRate() const {
+            const uint64_t total = hits + misses;
+            return total > 0 ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+        }
+    };
+
+    /**
+     * @param inner Model that runs on a miss (must not be null)
+     * @param budget_bytes Memory budget for cached entries
+     * @param quantisation_steps Levels over [0, 1] for f0_norm and loudness_norm
+     */
+    MemoizedControlModel(std::unique_ptr<IControlModel> inner, size_t budget_bytes,
+                         int quantisation_steps = 4096);
+    ~MemoizedControlModel() override = default;
+
+    bool loadModel(const std::string& model_path, const ModelLoadOptions& options) override;
+    bool loadModelFromBlob(std::shared_ptr<const ModelBlob> blob, const ModelLoadOptions& options) override;
+    using IControlModel::loadModel;
+
+    void reset() override;
+    size_t stateSize() const override { return inner_->stateSize(); }
+    bool getState(float* dst, size_t size) const override;
+    bool setState(const float* src, size_t size) override;
+    bool isLoaded() const override { return inner_->isLoaded(); }
+    void releaseThreads() override { inner_->releaseThreads(); }
+    bool acquireThreads() override { return inner_->acquireThreads(); }
+    ControlModelBackend backend() const override { return inner_->backend(); }
+    const ModelSignature& getSignature() const override { return inner_->getSignature(); }
+
+    /**
+     * Hit/miss/eviction counters and current footprint
+     */
+    CacheStats getCacheStats() const;
+
+    /**
+     * Drop all entries (counters are kept)
+     */
+    void clearCache();
+
+protected:
+    bool invoke(const AudioFeatures& input, SynthesisControls& output) override;
+
+private:
+    struct Entry {
+        uint64_t key;
+        std::vector<float> values;  // amplitude, harmonics, noise, then GRU state
+    };
+
+    std::unique_ptr<IControlModel> inner_;
+    size_t budget_bytes_;
+    float quantisation_steps_;
+
+    uint64_t key_;
+
+    // After a hit the inner model lags behind; its state is restored lazily
+    bool inner_stale_;
+    std::vector<float> state_;
+
+    std::list<Entry> lru_;  // Most recent first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+    size_t bytes_;
+    size_t control_values_;  // amplitude + harmonics + noise of the loaded model
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<size_t> entries_{0};
+    std::atomic<size_t> bytes_published_{0};
+
+    size_t entryBytes() const;
+
+    /**
+     * Start from an empty cache sized for the freshly loaded inner model
+     */
+    bool finishLoad(bool loaded);
+    void insert(uint64_t key, const SynthesisControls& output);
+    void publishFootprint();
+};
+
+} // namespace ddsp
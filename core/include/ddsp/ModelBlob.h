@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ddsp {
+
+/**
+ * Read-only model file contents shared between interpreters
+ *
+ * Either a read-only memory mapping of the file (pages are shared between
+ * interpreters and processes, and the OS can drop them under pressure), an
+ * owned heap copy where mapping is unavailable, or a view of caller memory
+ * (a model embedded with ddsp_embed_model(), an asset buffer, a region the
+ * caller mapped). TFLite does not copy the buffer, so each interpreter keeps
+ * its blob alive via shared_ptr.
+ *
+ * Thread-safety: immutable after creation; safe to share.
+ */
+class ModelBlob {
+public:
+    ~ModelBlob();
+
+    ModelBlob(const ModelBlob&) = delete;
+    ModelBlob& operator=(const ModelBlob&) = delete;
+
+    /**
+     * Map a model file read-only, falling back to reading it into memory
+     * @return nullptr if the file cannot be opened or is empty
+     */
+    static std::shared_ptr<const ModelBlob> mapFile(const std::string& path);
+
+    /**
+     * View caller-owned model bytes without copying
+     *
+     * The bytes must stay valid and unchanged while the blob (and any model
+     * loaded from it) exists; `owner`, if given, is kept alive for that long
+     * (e.g. a shared_ptr whose deleter unmaps the region). TFLite expects the
+     * buffer 16-byte aligned.
+     * @return nullptr if data is null or size is 0
+     */
+    static std::shared_ptr<const ModelBlob> wrap(const void* data, size_t size,
+                                                 std::shared_ptr<const void> owner = nullptr);
+
+    /**
+     * Copy model bytes into an owned buffer (caller memory can be freed)
+     * @return nullptr if data is null or size is 0
+     */
+    static std::shared_ptr<const ModelBlob> copyOf(const void* data, size_t size);
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    /**
+     * File the blob came from ("" if none); base path for side caches
+     */
+    const std::string& path() const { return path_; }
+
+    bool isMapped() const { return mapped_; }
+
+private:
+    ModelBlob() = default;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    std::string path_;
+    bool mapped_ = false;
+
+    std::vector<uint8_t> owned_;  // Heap copy when not mapped
+    std::shared_ptr<const void> owner_;  // Keeps wrapped caller memory alive
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+};
+
+} // namespace ddsp
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "IControlModel.h"
+#include "ModelBlob.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ddsp {
+
+/**
+ * Instrument ID -> model file registry with a bounded model cache
+ *
+ * Models are loaded lazily on first acquire(). The registry keeps the
+ * mapped model file (ModelBlob) and a few idle, ready-to-run interpreters
+ * per instrument, evicting least-recently-used ones to stay within a
+ * memory budget. Interpreters checked out by voices are not counted and
+ * never evicted; a blob is only evicted when no interpreter uses it.
+ *
+ * Idle interpreters hold no InferenceScheduler threads: release() hands
+ * the lease back and acquire() leases again, which for TFLite rebuilds
+ * the interpreter from the mapped file (the XNNPACK weight cache keeps
+ * that cheap). Only checked-out models count against the thread budget.
+ *
+ * Interpreter memory is estimated as the model file size (packed weights
+ * plus arena are of that order for these models).
+ *
+ * Typical use:
+ *   registry.registerModel("violin", "models/Violin.tflite");
+ *   registry.prefetch("violin");                // e.g. when the level loads
+ *   auto model = registry.acquire("violin");     // hit: no load on the voice
+ *   pipeline.adoptModel(std::move(model));
+ *   ...
+ *   registry.release("violin", pipeline.releaseModel());
+ *
+ * Thread-safety: all methods are thread-safe. acquire() blocks while
+ * loading on a miss; call it off the audio thread.
+ */
+class ModelRegistry {
+public:
+    struct Config {
+        size_t memory_budget_bytes = 64 * 1024 * 1024;
+        int max_idle_per_model = 2;        // Idle interpreters kept per instrument
+        ControlModelBackend backend = ControlModelBackend::Default;
+        ModelLoadOptions load_options;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;             // acquire() served by an idle interpreter
+        uint64_t blob_hits = 0;        // Miss, but the model file was already mapped
+        uint64_t misses = 0;           // acquire() that had to map the file
+        uint64_t evictions = 0;        // Idle interpreters + blobs evicted for the budget
+        uint64_t prefetches = 0;       // Prefetch hints completed
+        size_t resident_bytes = 0;     // Cached blobs + idle interpreters (estimate)
+        size_t cached_blobs = 0;
+        size_t idle_interpreters = 0;
+
+        double hitRate() const {
+            const uint64_t total = hits + blob_hits + misses;
+            return total > 0 ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+        }
+    };
+
+    ModelRegistry();
+    explicit ModelRegistry(const Config& config);
+    ~ModelRegistry();
+
+    ModelRegistry(const ModelRegistry&) = delete;
+    ModelRegistry& operator=(const ModelRegistry&) = delete;
+
+    /**
+     * Map an instrument ID to a model file (replaces an existing mapping)
+     */
+    void registerModel(const std::string& id, const std::string& model_path);
+
+    /**
+     * Ready-to-run model for an instrument (state reset)
+     * @return nullptr if the ID is unknown or loading failed
+     */
+    std::unique_ptr<IControlModel> acquire(const std::string& id);
+
+    /**
+     * Return a model obtained from acquire(); kept idle if within limits
+     */
+    void release(const std::string& id, std::unique_ptr<IControlModel> model);
+
+    /**
+     * Hint that an instrument will play soon: map it and prepare one idle
+     * interpreter on the registry's background thread
+     */
+    void prefetch(const std::string& id);
+
+    void setMemoryBudget(size_t bytes);
+
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        std::string path;
+        std::shared_ptr<const ModelBlob> blob;
+        std::vector<std::unique_ptr<IControlModel>> idle;
+        uint64_t last_used = 0;
+    };
+
+    Config config_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    uint64_t clock_ = 0;
+    Stats stats_;
+
+    // Prefetch worker
+    std::condition_variable prefetch_cv_;
+    std::deque<std::string> prefetch_queue_;
+    bool stopping_ = false;
+    std::thread prefetch_thread_;
+
+    std::shared_ptr<const ModelBlob> mapBlob(const std::string& id);
+    std::unique_ptr<IControlModel> createModel(const std::shared_ptr<const ModelBlob>& blob);
+    void prefetchLoop();
+
+    size_t residentBytesLocked() const;
+
+    /**
+     * Evict LRU idle interpreters, then unused blobs, until within budget
+     * Evicted models are moved to `garbage` so they are freed outside the lock.
+     */
+    void enforceBudgetLocked(std::vector<std::unique_ptr<IControlModel>>& garbage);
+};
+
+} // namespace ddsp
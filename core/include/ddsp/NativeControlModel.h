@@ -0,0 +1,115 @@
+#pragma once
+
+#include "IControlModel.h"
+#include <vector>
+
+namespace ddsp {
+
+/**
+ * Built-in C++ inference engine for the DDSP RnnFcDecoder
+ *
+ * Runs the decoder used by the exported .tflite models without any
+ * inference library:
+ *   f0, loudness -> per-input fc stacks -> GRU -> fc stack -> dense
+ *   -> exp_sigmoid (noise magnitudes biased by -5, as in ddsp.synths)
+ *
+ * Each fc layer is Dense -> LayerNorm -> LeakyReLU(0.2). The GRU follows
+ * the Keras convention (reset_after = true, gate order z, r, h).
+ *
+ * Weights are read from a little-endian .ddspw file:
+ *   char[8]  "DDSPNATV"
+ *   uint32   version (1)
+ *   uint32   input_layers, input_channels, gru_size,
+ *            output_layers, output_channels, num_harmonics, num_noise_amps
+ *   float32  tensors, in this order:
+ *     f0 stack, loudness stack: per layer kernel[in][ch], bias[ch], gamma[ch], beta[ch]
+ *     GRU: kernel[2*ch][3*gru], recurrent_kernel[gru][3*gru], bias[2][3*gru]
+ *     output stack: per layer kernel[in][out_ch], bias, gamma, beta
+ *                   (first layer in = 2*ch + gru)
+ *     dense_out: kernel[out_ch][1 + harmonics + noise], bias
+ *
+ * All working memory is allocated in loadModel(); invoke() does not allocate.
+ *
+ * Thread-safety: NOT thread-safe. Use from single thread only.
+ */
+class NativeControlModel : public IControlModel {
+public:
+    NativeControlModel();
+    ~NativeControlModel() override = default;
+
+    /**
+     * Load weights from a .ddspw file
+     * @param model_path Path to weight file
+     * @param options Only warmup_invocations applies (single-threaded engine)
+     * @return true if successful
+     */
+    bool loadModel(const std::string& model_path, const ModelLoadOptions& options) override;
+    using IControlModel::loadModel;
+
+    void reset() override;
+    size_t stateSize() const override;
+    bool getState(float* dst, size_t size) const override;
+    bool setState(const float* src, size_t size) override;
+    bool isLoaded() const override { return model_loaded_; }
+    ControlModelBackend backend() const override { return ControlModelBackend::Native; }
+
+protected:
+    bool invoke(const AudioFeatures& input, SynthesisControls& output) override;
+
+private:
+    struct FcLayer {
+        int in_size = 0;
+        int out_size = 0;
+        std::vector<float> kernel;  // [in_size][out_size]
+        std::vector<float> bias;
+        std::vector<float> gamma;
+        std::vector<float> beta;
+    };
+
+    bool model_loaded_;
+
+    int gru_size_;
+    int num_harmonics_;
+    int num_noise_amps_;
+
+    std::vector<FcLayer> f0_stack_;
+    std::vector<FcLayer> loudness_stack_;
+    std::vector<FcLayer> output_stack_;
+
+    std::vector<float> gru_kernel_;            // [2*ch][3*gru]
+    std::vector<float> gru_recurrent_kernel_;  // [gru][3*gru]
+    std::vector<float> gru_input_bias_;        // [3*gru]
+    std::vector<float> gru_recurrent_bias_;    // [3*gru]
+
+    std::vector<float> dense_out_kernel_;      // [out_ch][1 + harmonics + noise]
+    std::vector<float> dense_out_bias_;
+
+    // Recurrent state and working buffers
+    std::vector<float> state_;
+    std::vector<float> f0_features_;
+    std::vector<float> loudness_features_;
+    std::vector<float> gru_input_;
+    std::vector<float> gru_x_;                 // x * kernel + bias [3*gru]
+    std::vector<float> gru_h_;                 // h * recurrent_kernel + bias [3*gru]
+    std::vector<float> output_input_;
+    std::vector<float> scratch_a_;
+    std::vector<float> scratch_b_;
+    std::vector<float> raw_output_;
+
+    /**
+     * Run an fc stack; returns pointer to the final activations
+     */
+    const float* runStack(const std::vector<FcLayer>& stack, const float* input);
+
+    /**
+     * Dense -> LayerNorm -> LeakyReLU for one layer
+     */
+    static void runFcLayer(const FcLayer& layer, const float* input, float* output);
+
+    /**
+     * One GRU step, updates state_ in place
+     */
+    void runGru(const float* input);
+};
+
+} // namespace ddsp
@@ -16,7 +16,7 @@ namespace ddsp {
  *
  * Features:
  * - Frequency-sampling FIR design (IFFT of magnitude spectrum)
- * - Zero-phase Hann window (128 taps)
+ * - Zero-phase Hann window ((num_noise_amps - 1) * 2 taps, 128 for 65 bands)
  * - Frequency-domain convolution with white noise
  * - Group delay compensation
  *
@@ -26,7 +26,7 @@ class NoiseSynthesizer {
 public:
     /**
      * Constructor
-     * @param num_noise_amps Number of noise bands (default 65)
+     * @param num_noise_amps Number of noise bands (default 65); see isSupportedBandCount
      * @param num_output_samples Samples per frame (default 320)
      */
     NoiseSynthesizer(
@@ -49,14 +49,32 @@ public:
      */
     void reset();
 
+    /**
+     * Restart the noise sequence from a fixed seed (reproducible renders)
+     * Seeded from std::random_device otherwise.
+     */
+    void seed(uint32_t value);
+
+    int getNumNoiseAmps() const { return num_noise_amps_; }
+
+    /**
+     * Heap used by buffers and FFT plans, in bytes (plans estimated)
+     */
+    size_t getMemoryBytes() const;
+
+    /**
+     * The FIR design needs (num_noise_amps - 1) to be a power of two
+     */
+    static bool isSupportedBandCount(int num_noise_amps);
+
 private:
     int num_noise_amps_;
     int num_output_samples_;
     int impulse_response_size_;  // (num_noise_amps - 1) * 2 = 128
 
     // FFT objects (JUCE)
-    juce::dsp::FFT window_fft_;   // 128-point for windowing
-    juce::dsp::FFT convolve_fft_; // 512-point for convolution
+    juce::dsp::FFT window_fft_;   // Impulse-response sized (128-point for 65 bands)
+    juce::dsp::FFT convolve_fft_; // Fits IR + frame (512-point for 65 bands)
 
     // Random number generation
     std::mt19937 rng_;
@@ -0,0 +1,247 @@
+#pragma once
+
+#include "DDSPTypes.h"
+#include "IControlModel.h"
+#include "MemoizedControlModel.h"
+#include "HarmonicSynthesizer.h"
+#include "NoiseSynthesizer.h"
+#include "PolyphaseResampler.h"
+#include "ControlEvents.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+namespace ddsp {
+
+/**
+ * Faster-than-realtime renderer for bulk and offline generation
+ *
+ * Renders a whole control sequence in one call on the calling thread:
+ * inference, synthesis and resampling run back to back with no FIFOs,
+ * sleeps or atomics, straight into the caller's buffer or a streaming
+ * sink. Controls are given per model frame (one hop, 20 ms) as f0/loudness
+ * arrays, or as ControlEvents which are averaged per frame the same way
+ * InferencePipeline::pushControlEvent() does.
+ *
+ * Each render starts from a reset model and synthesizers, and frame n's
+ * noise is seeded from (noise_seed, n), so equal inputs give equal output.
+ *
+ * renderParallel() splits long sequences into chunks rendered on separate
+ * threads. The GRU state is not known at a chunk boundary, so each chunk
+ * first renders warmup_frames of the preceding controls for the state to
+ * converge, and the last crossfade_frames of that warm-up are crossfaded
+ * with the previous chunk. Harmonic phase and noise do not depend on the
+ * model state and are reconstructed exactly, so the only difference from
+ * a serial render is the residual GRU error after the warm-up.
+ *
+ * Thread-safety: NOT thread-safe. Use one renderer per thread.
+ */
+class OfflineRenderer {
+public:
+    struct Options {
+        double sample_rate = 48000.0;
+        PolyphaseResampler::Quality resampler_quality = PolyphaseResampler::Quality::High;
+        float pitch_shift_semitones = 0.0f;
+        float harmonic_gain = 1.0f;
+        float noise_gain = 1.0f;
+        uint32_t noise_seed = 0x5eed;
+        int sink_block_frames = 16;  // Frames per sink callback
+    };
+
+    /**
+     * Timing of the most recent render
+     */
+    struct Stats {
+        int64_t frames = 0;
+        int64_t samples = 0;
+        double audio_seconds = 0.0;
+        double render_seconds = 0.0;      // Wall time of the whole render
+        double inference_seconds = 0.0;   // Part spent in the control model
+
+        double realtimeFactor() const {
+            return render_seconds > 0.0 ? audio_seconds / render_seconds : 0.0;
+        }
+    };
+
+    struct ParallelOptions {
+        int num_threads = 0;          // 0 = hardware threads
+        int chunk_frames = 1500;      // Frames owned by each chunk (30 s)
+        int warmup_frames = 100;      // Preceding frames rendered to settle the GRU state
+        int crossfade_frames = 4;     // Trailing warm-up frames crossfaded into the output
+        bool compare_serial = false;  // Also render serially to measure speedup and error
+    };
+
+    struct ParallelStats {
+        int chunks = 0;
+        int threads = 0;
+        double parallel_seconds = 0.0;  // Wall time of the parallel render
+        double serial_seconds = 0.0;    // Measured with compare_serial, else estimated from chunk times
+        bool serial_measured = false;
+        double speedup = 0.0;           // serial_seconds / parallel_seconds
+        double max_abs_error = 0.0;     // Against the serial render (compare_serial only)
+        double error_db = 0.0;          // RMS error relative to serial RMS (compare_serial only)
+    };
+
+    /**
+     * Receives consecutive output blocks; return false to stop the render
+     */
+    using Sink = std::function<bool(const float* samples, int num_samples)>;
+
+    /**
+     * Creates the per-thread models for renderParallel()
+     */
+    using ModelFactory = std::function<std::unique_ptr<IControlModel>()>;
+
+    OfflineRenderer();
+    explicit OfflineRenderer(const Options& options);
+    ~OfflineRenderer();
+
+    OfflineRenderer(const OfflineRenderer&) = delete;
+    OfflineRenderer& operator=(const OfflineRenderer&) = delete;
+
+    /**
+     * Output rate, resampler quality, gains and seed for later renders
+     */
+    void setOptions(const Options& options);
+    const Options& getOptions() const { return options_; }
+
+    bool loadModel(const std::string& model_path, const ModelLoadOptions& options = ModelLoadOptions(),
+                   ControlModelBackend backend = ControlModelBackend::Default);
+
+    /**
+     * Take ownership of an already loaded model (e.g. from ModelRegistry)
+     */
+    bool adoptModel(std::unique_ptr<IControlModel> model);
+    std::unique_ptr<IControlModel> releaseModel();
+
+    bool isReady() const { return model_ != nullptr; }
+
+    /**
+     * Model source for parallel workers
+     * loadModel() installs one that reloads the same file single-threaded;
+     * adoptModel() clears it. Without a factory renderParallel() runs the
+     * chunks on the calling thread.
+     */
+    void setModelFactory(ModelFactory factory);
+
+    /**
+     * Output samples per model frame at the configured rate
+     */
+    int getHopSize() const { return hop_size_; }
+    int64_t getNumOutputSamples(int64_t num_frames) const { return num_frames * hop_size_; }
+
+    /**
+     * Render per-frame controls
+     * @param output Room for getNumOutputSamples(num_frames) samples
+     * @return Samples written, or -1 if no model is loaded or inference failed
+     */
+    int64_t render(const float* f0_hz, const float* loudness_norm, int64_t num_frames, float* output);
+    int64_t render(const float* f0_hz, const float* loudness_norm, int64_t num_frames, const Sink& sink);
+
+    /**
+     * Render num_samples of output driven by timestamped events
+     *
+     * sample_time is the output sample the event applies at. Before the
+     * first event the voice is silent at 440 Hz. Exactly num_samples are
+     * produced; a trailing partial frame is rendered whole and trimmed.
+     * @param output Room for num_samples samples
+     */
+    int64_t renderEvents(const std::vector<ControlEvent>& events, int64_t num_samples, float* output);
+    int64_t renderEvents(const std::vector<ControlEvent>& events, int64_t num_samples, const Sink& sink);
+
+    /**
+     * Render per-frame controls in chunks on several threads
+     * @param output Room for getNumOutputSamples(num_frames) samples
+     * @return Samples written, or -1 on failure
+     */
+    int64_t renderParallel(const float* f0_hz, const float* loudness_norm, int64_t num_frames, float* output,
+                           const ParallelOptions& options);
+    int64_t renderParallel(const float* f0_hz, const float* loudness_norm, int64_t num_frames, float* output) {
+        return renderParallel(f0_hz, loudness_norm, num_frames, output, ParallelOptions{});
+    }
+
+    /**
+     * Chunking, speedup and error of the most recent renderParallel()
+     */
+    const ParallelStats& getParallelStats() const { return parallel_stats_; }
+
+    /**
+     * Per-frame f0/loudness/note-on from events (coverage-weighted per hop)
+     */
+    static void eventsToFrames(const std::vector<ControlEvent>& events, int64_t num_frames, int hop_size,
+                               std::vector<float>& f0_hz, std::vector<float>& loudness_norm,
+                               std::vector<uint8_t>& note_on);
+
+    const Stats& getStats() const { return stats_; }
+
+    /**
+     * Prefix-memoised inference statistics, summed over the parallel workers
+     * All zero unless the model was loaded with options.inference_cache_bytes > 0.
+     */
+    MemoizedControlModel::CacheStats getInferenceCacheStats() const;
+
+private:
+    Options options_;
+    int hop_size_ = 0;
+
+    std::unique_ptr<IControlModel> model_;
+    std::unique_ptr<HarmonicSynthesizer> harmonic_synth_;
+    std::unique_ptr<NoiseSynthesizer> noise_synth_;
+    HarmonicSynthesizer::State harmonic_state_;
+
+    PolyphaseResampler resampler_;
+    juce::WindowedSincInterpolator fallback_interpolator_;  // Non-rational ratios
+
+    AudioFeatures features_;
+    SynthesisControls controls_;
+    std::vector<float> synthesis_buffer_;  // One model-rate hop
+    std::vector<float> sink_buffer_;       // sink_block_frames hops at the output rate
+
+    std::vector<float> event_f0_;
+    std::vector<float> event_loudness_;
+    std::vector<uint8_t> event_note_on_;
+
+    Stats stats_;
+
+    // Parallel rendering
+    ModelFactory model_factory_;
+    std::vector<std::unique_ptr<OfflineRenderer>> workers_;  // Kept between renders (models loaded once)
+    ParallelStats parallel_stats_;
+
+    void prepareResampler();
+
+    /**
+     * Grow workers_ to count renderers with this renderer's options
+     */
+    bool prepareWorkers(int count);
+
+    /**
+     * Render frames [first_frame, first_frame + num_frames) from a harmonic state
+     */
+    int64_t renderChunk(const float* f0_hz, const float* loudness_norm, int64_t first_frame, int64_t num_frames,
+                        const HarmonicSynthesizer::State& harmonic_state, float* output);
+
+    /**
+     * Reset model, synthesizers, resampler and noise seed
+     */
+    void resetVoice();
+
+    /**
+     * Render frames into output (if not null) or sink; no reset
+     * @param max_samples Trim the output to this many samples (-1 = whole frames)
+     * @return Samples produced, or -1 on failure
+     */
+    int64_t renderFrames(const float* f0_hz, const float* loudness_norm, const uint8_t* note_on,
+                         int64_t num_frames, float* output, const Sink* sink, int64_t first_frame = 0,
+                         int64_t max_samples = -1);
+
+    /**
+     * Inference, synthesis and resampling of one frame into dst[hop_size_]
+     */
+    bool renderFrame(float f0_hz, float loudness_norm, bool note_on, int64_t frame, float* dst);
+};
+
+} // namespace ddsp
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "IControlModel.h"
+#include <array>
+#include <memory>
+
+namespace ddsp {
+
+/**
+ * ONNX Runtime backend for DDSP control prediction
+ *
+ * Expects an .onnx export of the same decoder as the .tflite models
+ * (e.g. via tf2onnx), with the tensor names from DDSPTypes.h.
+ * Only compiled when DDSP_WITH_ONNXRUNTIME is enabled.
+ *
+ * Thread-safety: NOT thread-safe. Use from single thread only.
+ */
+class OnnxControlModel : public IControlModel {
+public:
+    OnnxControlModel();
+    ~OnnxControlModel() override;
+
+    OnnxControlModel(const OnnxControlModel&) = delete;
+    OnnxControlModel& operator=(const OnnxControlModel&) = delete;
+
+    /**
+     * Load ONNX model from file
+     * @param model_path Path to .onnx model file
+     * @param options Load options; threads come from the shared pool (InferenceScheduler)
+     * @return true if successful
+     */
+    bool loadModel(const std::string& model_path, const ModelLoadOptions& options) override;
+    using IControlModel::loadModel;
+
+    /**
+     * Load from in-memory model bytes (ONNX Runtime copies what it needs)
+     */
+    bool loadModelFromBlob(std::shared_ptr<const ModelBlob> blob, const ModelLoadOptions& options) override;
+
+    void reset() override;
+    size_t stateSize() const override;
+    bool getState(float* dst, size_t size) const override;
+    bool setState(const float* src, size_t size) override;
+    bool isLoaded() const override { return model_loaded_; }
+    ControlModelBackend backend() const override { return ControlModelBackend::OnnxRuntime; }
+
+protected:
+    bool invoke(const AudioFeatures& input, SynthesisControls& output) override;
+
+private:
+    // Keeps onnxruntime_cxx_api.h out of the public headers
+    struct Session;
+
+    bool model_loaded_;
+    std::unique_ptr<Session> session_;
+
+    // Shared body of loadModel/loadModelFromBlob (blob == nullptr: load from path)
+    bool loadSession(const std::string& model_path, const ModelBlob* blob, const ModelLoadOptions& options);
+
+    // GRU state (512 floats, persists between frames)
+    std::array<float, kGruModelStateSize> gruState_;
+};
+
+} // namespace ddsp
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ddsp {
+
+/**
+ * Fixed-ratio polyphase FIR resampler
+ *
+ * Converts between integer sample rates whose ratio reduces to
+ * L/M with L <= kMaxPhases (16k -> 48k is 3/1, 16k -> 44.1k is 441/160).
+ * The Kaiser-windowed sinc prototype is split into L phase filters at
+ * prepare(); each output sample is then one dot product of a phase filter
+ * with the most recent input. Phase rows are stored reversed, padded to a
+ * multiple of kLaneWidth and 64-byte aligned, so the inner loop is a
+ * contiguous multiply-add the compiler vectorises. Tables are shared by
+ * every resampler with the same ratio and quality (441 phases at 44.1k
+ * would otherwise be per instance); only the input history is per instance.
+ *
+ * prepare() returns false for ratios it cannot represent (non-integer
+ * rates, too many phases); callers keep a generic interpolator for those.
+ *
+ * Thread-safety: NOT thread-safe. prepare() allocates; process() and
+ * reset() do not.
+ */
+class PolyphaseResampler {
+public:
+    enum class Quality {
+        Low,     // 16 taps per phase
+        Medium,  // 32 taps per phase
+        High     // 64 taps per phase
+    };
+
+    static constexpr int kMaxPhases = 1024;
+    static constexpr int kLaneWidth = 8;
+
+    PolyphaseResampler() = default;
+
+    /**
+     * Build the phase tables for input_rate -> output_rate
+     * @param max_input_samples Largest input block passed to process()
+     * @return false if the ratio is not supported (the resampler stays unprepared)
+     */
+    bool prepare(double input_rate, double output_rate, int max_input_samples,
+                 Quality quality = Quality::Medium);
+
+    bool isPrepared() const { return interpolation_ > 0; }
+
+    /**
+     * Clear the input history and restart the phase
+     */
+    void reset();
+
+    /**
+     * Resample one block, carrying history to the next call
+     * @param input num_input samples (num_input <= max_input_samples)
+     * @param output Room for getMaxOutputSamples(num_input) samples
+     * @return Number of output samples written
+     */
+    int process(const float* input, int num_input, float* output);
+
+    /**
+     * Upper bound on process() output for num_input samples
+     */
+    int getMaxOutputSamples(int num_input) const;
+
+    /**
+     * Filter group delay in input samples
+     */
+    double getLatencyInputSamples() const;
+
+    int getInterpolation() const { return interpolation_; }
+    int getDecimation() const { return decimation_; }
+    int getTapsPerPhase() const { return taps_; }
+    Quality getQuality() const { return quality_; }
+
+    /**
+     * Heap owned by this instance (input history), in bytes
+     */
+    size_t getMemoryBytes() const;
+
+    /**
+     * Size of the shared coefficient table, in bytes
+     */
+    size_t getTableBytes() const;
+
+    static int tapsForQuality(Quality quality);
+
+private:
+    int interpolation_ = 0;  // L
+    int decimation_ = 0;     // M
+    int taps_ = 0;           // Taps per phase
+    int stride_ = 0;         // taps_ rounded up to kLaneWidth
+    int max_input_ = 0;
+    Quality quality_ = Quality::Medium;
+
+    struct Table;
+    std::shared_ptr<const Table> table_;   // Shared between equal ratio/quality
+    const float* coefficients_ = nullptr;  // [interpolation_][stride_], aligned, in table_
+
+    std::vector<float> history_;     // stride_ - 1 past samples, then the current block
+    int64_t time_ = 0;               // Next output position, in 1/L input samples
+
+    /**
+     * Cached table for a reduced ratio, built on first use
+     */
+    static std::shared_ptr<const Table> acquireTable(int64_t up, int64_t down, Quality quality, int stride);
+};
+
+} // namespace ddsp
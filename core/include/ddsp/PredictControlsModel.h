@@ -1,75 +1,137 @@
 #pragma once
 
-#include "DDSPTypes.h"
+#include "IControlModel.h"
+#include "InferenceScheduler.h"
 #include <string>
 #include <array>
-#include <unordered_map>
+#include <vector>
 
 // Forward declarations for TFLite C types
 struct TfLiteModel;
 struct TfLiteInterpreterOptions;
 struct TfLiteInterpreter;
 struct TfLiteDelegate;
+struct TfLiteTensor;
 
 namespace ddsp {
 
 /**
- * Wraps TensorFlow Lite model for DDSP control prediction
+ * TensorFlow Lite backend for DDSP control prediction
  *
  * Takes normalized audio features (f0, loudness) and predicts
  * synthesis controls (amplitude, harmonics, noise magnitudes).
+ * Only compiled when the TFLite library is found (DDSP_WITH_TFLITE).
  *
  * Key features:
- * - Uses tensor names for matching (order-agnostic)
+ * - Uses tensor names for matching (order-agnostic); names come from a
+ *   <model>.meta sidecar or the ddsp-vst defaults, and tensors not found
+ *   by name are matched by shape
+ * - Harmonic, noise and GRU state sizes are read from the model
  * - Maintains GRU state between frames
  * - Supports XNNPACK and CoreML delegates
+ * - Optional delegate/thread autotuning with an on-disk result cache
+ * - Warm-up invocations and a persisted XNNPACK weight cache at load,
+ *   so the first real frame does not pay for weight packing
  *
  * Thread-safety: NOT thread-safe. Use from single thread only.
  */
-class PredictControlsModel {
+class PredictControlsModel : public IControlModel {
 public:
     PredictControlsModel();
-    ~PredictControlsModel();
+    ~PredictControlsModel() override;
 
     // Delete copy/move (TFLite interpreter shouldn't be copied)
     PredictControlsModel(const PredictControlsModel&) = delete;
     PredictControlsModel& operator=(const PredictControlsModel&) = delete;
 
+    enum class DelegateType {
+        None,
+        CoreML,
+        XNNPACK
+    };
+
+    /**
+     * Delegate configuration chosen at load time
+     */
+    struct DelegateConfig {
+        DelegateType delegate = DelegateType::XNNPACK;
+        int num_threads = 2;
+        double p99_us = 0.0;      // Measured p99 latency (autotune only)
+        bool autotuned = false;   // Chosen by sweep or cache
+        bool from_cache = false;  // Loaded from the autotune cache
+    };
+
     /**
      * Load TFLite model from file
+     *
+     * With options.autotune, benchmarks {no delegate, XNNPACK} x {1, 2, 4}
+     * threads (up to the InferenceScheduler's per-invocation cap) and keeps
+     * the configuration with the best p99. The decision is cached per model
+     * hash, CPU model and cap so later loads skip the sweep; a sweep the
+     * thread budget cut short is not cached.
+     *
      * @param model_path Path to .tflite model file
-     * @param num_threads Number of threads for inference
+     * @param options Threading and autotune options
      * @return true if successful
      */
-    bool loadModel(const std::string& model_path, int num_threads = 2);
+    bool loadModel(const std::string& model_path, const ModelLoadOptions& options) override;
+    using IControlModel::loadModel;
 
     /**
-     * Run inference
-     *
-     * @param input Audio features (f0_norm, loudness_norm must be set)
-     * @param output Synthesis controls (amplitude, harmonics, noiseAmps)
-     * @return true if inference successful
+     * Load from shared model bytes (e.g. a ModelBlob mapped once and
+     * shared by several interpreters); the blob is kept alive
      */
-    bool call(const AudioFeatures& input, SynthesisControls& output);
+    bool loadModelFromBlob(std::shared_ptr<const ModelBlob> blob, const ModelLoadOptions& options) override;
 
     /**
      * Reset model state (clears GRU state)
      */
-    void reset();
+    void reset() override;
+
+    /**
+     * GRU state snapshot/restore
+     */
+    size_t stateSize() const override { return gruState_.size(); }
+    bool getState(float* dst, size_t size) const override;
+    bool setState(const float* src, size_t size) override;
 
     /**
      * Check if model is loaded and ready
      */
-    bool isLoaded() const { return model_loaded_; }
+    bool isLoaded() const override { return model_loaded_; }
+
+    /**
+     * Threads are fixed per interpreter, so releasing them frees the
+     * interpreter; acquireThreads() rebuilds it from the loaded model
+     */
+    void releaseThreads() override;
+    bool acquireThreads() override;
+
+    ControlModelBackend backend() const override { return ControlModelBackend::TFLite; }
+
+    /**
+     * Delegate configuration in use
+     */
+    const DelegateConfig& getDelegateConfig() const { return delegate_config_; }
+
+protected:
+    /**
+     * Run inference
+     *
+     * @param input Audio features (f0_norm, loudness_norm must be set)
+     * @param output Synthesis controls (amplitude, harmonics, noiseAmps)
+     * @return true if inference successful
+     */
+    bool invoke(const AudioFeatures& input, SynthesisControls& output) override;
 
 private:
     bool model_loaded_;
 
-    enum class DelegateType {
-        None,
-        CoreML,
-        XNNPACK
-    };
+    // Model file contents (TfLiteModelCreate does not copy the buffer)
+    std::shared_ptr<const ModelBlob> model_blob_;
+
+    // XNNPACK weight cache file ("" = disabled); must outlive delegate creation
+    std::string weight_cache_path_;
 
     // TFLite objects
     TfLiteModel* model_;
@@ -77,19 +139,59 @@ private:
     TfLiteInterpreter* interpreter_;
     TfLiteDelegate* delegate_;
     DelegateType delegate_type_;
+    DelegateConfig delegate_config_;
+    DelegateConfig requested_config_;  // Before the scheduler's clamp; reused by acquireThreads()
+
+    // Worker threads leased from the process-wide budget for interpreter_
+    InferenceScheduler::ThreadLease thread_lease_;
 
-    std::unordered_map<std::string, int> input_indices_;
-    std::unordered_map<std::string, int> output_indices_;
+    // Names requested by the sidecar/defaults; signature_ holds what was found
+    ModelSignature requested_signature_;
 
-    // GRU state (512 floats, persists between frames)
-    std::array<float, kGruModelStateSize> gruState_;
+    // Resolved once per interpreter: f0, loudness, state / amplitude, harmonics, noise, state
+    std::array<TfLiteTensor*, kNumPredictControlsInputTensors> input_tensors_;
+    std::array<const TfLiteTensor*, kNumPredictControlsOutputTensors> output_tensors_;
+
+    // GRU state (signature_.state_size floats, persists between frames)
+    std::vector<float> gruState_;
+
+    /**
+     * Shared body of loadModel/loadModelFromBlob
+     */
+    bool loadFromBlob(std::shared_ptr<const ModelBlob> blob, const ModelLoadOptions& options, double file_read_ms);
+
+    /**
+     * Create interpreter for a delegate configuration
+     */
+    bool createInterpreter(const DelegateConfig& config);
 
     /**
      * Initialize delegate (XNNPACK or CoreML)
      */
-    bool initializeDelegate(int num_threads);
+    bool initializeDelegate(DelegateType type, int num_threads);
+
+    /**
+     * Sweep delegate x threads and return the best configuration
+     * @param max_threads Skip candidates above this (0 = no cap)
+     * @param complete Set false if the thread budget clamped a candidate
+     */
+    bool autotune(const ModelLoadOptions& options, int max_threads, DelegateConfig& best, bool& complete);
+
+    /**
+     * Measure p99 latency of the current interpreter
+     */
+    double measureP99(int warmup_invocations, int timed_invocations);
+
+    void releaseInterpreter();
     void releaseResources();
-    bool cacheTensorIndices();
+
+    /**
+     * Bind input/output tensors by requested name, falling back to shape
+     * (scalar inputs f0 then loudness, largest input the state; scalar
+     * output the amplitude, state-sized output the state, remaining two
+     * harmonics then noise), and fill signature_ from the tensor sizes
+     */
+    bool resolveSignature();
 };
 
 } // namespace ddsp
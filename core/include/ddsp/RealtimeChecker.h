@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace ddsp {
+
+/**
+ * Real-time safety checker for the render path
+ *
+ * Code running inside a RealtimeChecker::Scope must not allocate, free or
+ * lock a mutex. Builds configured with DDSP_REALTIME_CHECKS=ON intercept
+ * malloc/calloc/realloc/free (and so operator new/delete) and
+ * pthread_mutex_lock; while checking is enabled, every such call made on a
+ * thread inside a scope is counted and the first kMaxViolations are kept
+ * with a stack trace. Other builds only track the scope depth.
+ *
+ * Interception needs glibc and only sees calls that resolve to the
+ * executable's symbols, so link ddsp_core statically into the program
+ * under test.
+ *
+ * Thread-safety: all methods are thread-safe; getViolations() and
+ * report() allocate and belong on a non-real-time thread.
+ */
+class RealtimeChecker {
+public:
+    enum class ViolationKind {
+        Allocation,    // malloc, calloc, realloc, aligned allocation
+        Deallocation,  // free
+        MutexLock      // pthread_mutex_lock
+    };
+
+    static constexpr int kMaxStackFrames = 32;
+    static constexpr int kMaxViolations = 64;  // Kept with stack traces; later ones are only counted
+
+    struct Violation {
+        ViolationKind kind = ViolationKind::Allocation;
+        int num_frames = 0;
+        void* frames[kMaxStackFrames] = {};
+    };
+
+    /**
+     * Marks the calling thread as real-time for its lifetime (nestable)
+     */
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    /**
+     * True if this build intercepts allocations and locks
+     */
+    static bool isAvailable();
+
+    /**
+     * True while the calling thread is inside a Scope
+     */
+    static bool isRealtimeThread();
+
+    /**
+     * Start/stop recording violations (off by default)
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    static uint64_t getViolationCount();
+    static std::vector<Violation> getViolations();
+
+    /**
+     * Print each recorded violation with a symbolised stack trace
+     */
+    static void report(std::ostream& out);
+
+    /**
+     * Forget recorded violations
+     */
+    static void reset();
+
+    /**
+     * Record a violation if the calling thread is real-time (interceptors)
+     */
+    static void recordViolation(ViolationKind kind);
+
+    static const char* violationKindName(ViolationKind kind);
+};
+
+} // namespace ddsp
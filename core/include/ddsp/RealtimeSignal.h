@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace ddsp {
+
+/**
+ * Auto-reset wake-up signal with a lock-free signal()
+ *
+ * Replaces juce::WaitableEvent on the render path: signal() never takes a
+ * lock (POSIX sem_post, dispatch_semaphore_signal or ReleaseSemaphore, and
+ * only when no wake-up is already pending), so it may be called inside a
+ * RealtimeChecker::Scope. wait() blocks and belongs outside one.
+ *
+ * Like an auto-reset event, signals while one is pending coalesce; the
+ * waiter must re-check its condition after waking.
+ *
+ * Thread-safety: signal() from any thread; one waiter at a time.
+ */
+class RealtimeSignal {
+public:
+    RealtimeSignal();
+    ~RealtimeSignal();
+
+    RealtimeSignal(const RealtimeSignal&) = delete;
+    RealtimeSignal& operator=(const RealtimeSignal&) = delete;
+
+    void signal();
+
+    /**
+     * Wait for a signal
+     * @return false on timeout
+     */
+    bool wait(int timeout_ms);
+
+private:
+    struct Semaphore;
+    std::unique_ptr<Semaphore> semaphore_;
+    std::atomic<bool> pending_;
+};
+
+} // namespace ddsp
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ddsp {
+
+class InferencePipeline;
+
+/**
+ * Shared render workers for many InferencePipeline instances
+ *
+ * Without a pool every startTimer() spawns its own render thread, so N
+ * voices cost N threads that all sleep and wake every hop. Pipelines
+ * attached with InferencePipeline::setRenderPool() are instead serviced by
+ * a fixed set of workers: each pipeline has an owner worker and a
+ * deadline (one per hop interval); at its deadline the owner renders it up
+ * to its output watermark. A worker with nothing due steals pipelines of
+ * other workers once they are overdue by kStealSlack, so one slow voice
+ * does not hold up the rest of its owner's list.
+ *
+ * The thread count stays at getNumWorkers() however many voices run.
+ *
+ * Thread-safety: all methods are thread-safe. remove() blocks until no
+ * worker is rendering the pipeline; do not call it from a worker.
+ */
+class RenderPool {
+public:
+    static constexpr std::chrono::microseconds kStealSlack{1000};
+
+    struct Stats {
+        int workers = 0;           // Worker threads (constant once started)
+        int pipelines = 0;         // Registered pipelines
+        uint64_t wakeups = 0;      // Pipeline services (one per pipeline per interval)
+        uint64_t hops = 0;         // Hops rendered across all pipelines
+        uint64_t stolen = 0;       // Services run by a worker other than the owner
+        uint64_t late = 0;         // Services started a full interval past the deadline
+    };
+
+    /**
+     * Process-wide pool (workers = half the hardware threads)
+     */
+    static RenderPool& instance();
+
+    /**
+     * @param num_workers Worker threads; 0 = half the hardware threads
+     * Workers start with the first registered pipeline.
+     */
+    explicit RenderPool(int num_workers = 0);
+    ~RenderPool();
+
+    RenderPool(const RenderPool&) = delete;
+    RenderPool& operator=(const RenderPool&) = delete;
+
+    /**
+     * Change the worker count; ignored once workers have started
+     */
+    void setNumWorkers(int num_workers);
+    int getNumWorkers() const;
+
+    /**
+     * Schedule a pipeline every interval_ms, starting now
+     */
+    void add(InferencePipeline& pipeline, int interval_ms);
+
+    /**
+     * Stop scheduling a pipeline; waits for an in-flight render
+     */
+    void remove(InferencePipeline& pipeline);
+
+    Stats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        InferencePipeline* pipeline = nullptr;
+        Clock::duration period{};
+        Clock::time_point deadline{};
+        int interval_ms = 20;
+        int owner = 0;
+        bool busy = false;
+    };
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;   // Entries added/removed/finished, or shutdown
+    std::vector<std::unique_ptr<Entry>> entries_;
+    std::vector<std::thread> workers_;
+    int num_workers_;
+    bool stopping_;
+
+    std::atomic<uint64_t> wakeups_;
+    std::atomic<uint64_t> hops_;
+    std::atomic<uint64_t> stolen_;
+    std::atomic<uint64_t> late_;
+
+    void workerLoop(int index);
+
+    /**
+     * Due entry for a worker: its own first, else another worker's overdue one
+     * Called with mutex_ held.
+     */
+    Entry* claimDueEntry(int index, Clock::time_point now, Clock::time_point& next_wake);
+};
+
+} // namespace ddsp
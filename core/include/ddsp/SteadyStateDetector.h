@@ -0,0 +1,100 @@
+#pragma once
+
+#include "IControlModel.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace ddsp {
+
+/**
+ * Detects when inference has reached a fixed point
+ *
+ * During a sustained note the inputs stay constant and the GRU converges,
+ * so every further inference reproduces the same controls. After each
+ * inference the detector measures the largest state and output change
+ * since the previous hop; once both stay below their thresholds for
+ * min_converged_hops hops, shouldSkip() reports that the last controls
+ * can be reused. Any input change ends the skip immediately.
+ *
+ * Thread-safety: NOT thread-safe, except getStats() which may be called
+ * from any thread.
+ */
+class SteadyStateDetector {
+public:
+    struct Config {
+        float input_epsilon = 1e-6f;       // Max |f0_norm/loudness_norm change| treated as constant
+        float state_threshold = 1e-4f;     // Max |GRU state change| per hop
+        float output_threshold = 1e-4f;    // Max |control change| per hop
+        int min_converged_hops = 3;        // Consecutive converged hops before skipping
+        int max_skipped_hops = 50;         // Refresh after this many skips (0 = never)
+    };
+
+    struct Stats {
+        uint64_t hops = 0;          // Hops seen by shouldSkip()
+        uint64_t skipped_hops = 0;  // Hops that reused the previous controls
+        double saved_ms = 0.0;      // Skipped hops x mean inference time (filled by InferencePipeline)
+
+        double skipRate() const {
+            return hops > 0 ? static_cast<double>(skipped_hops) / static_cast<double>(hops) : 0.0;
+        }
+    };
+
+    SteadyStateDetector() = default;
+
+    void setConfig(const Config& config) { config_ = config; }
+    const Config& getConfig() const { return config_; }
+
+    /**
+     * Decide whether this hop can reuse the previous controls
+     * Counts the hop; call once per hop before inference.
+     */
+    bool shouldSkip(const AudioFeatures& input);
+
+    /**
+     * Record a completed inference
+     * @param model Model after call() (its state is read, not modified)
+     * @param output Controls produced by that call
+     */
+    void update(const IControlModel& model, const AudioFeatures& input, const SynthesisControls& output);
+
+    /**
+     * Size the history buffers for a model so update() never allocates
+     */
+    void prepare(const IControlModel& model);
+
+    /**
+     * Exchange history buffers with a detector prepare()d elsewhere, so a
+     * model swap on the render thread does not allocate; both are invalidated
+     */
+    void swapBuffers(SteadyStateDetector& other);
+
+    /**
+     * Forget convergence (model swap, state restore, reset)
+     * Counters are kept.
+     */
+    void invalidate();
+
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    Config config_;
+
+    bool has_previous_ = false;
+    int converged_hops_ = 0;
+    int skipped_in_row_ = 0;
+    AudioFeatures last_input_;
+
+    // Sized by prepare(); reallocated only if the model shape changes
+    std::vector<float> previous_state_;
+    std::vector<float> current_state_;
+    SynthesisControls previous_output_;
+
+    std::atomic<uint64_t> hops_{0};
+    std::atomic<uint64_t> skipped_hops_{0};
+
+    bool inputChanged(const AudioFeatures& input) const;
+};
+
+} // namespace ddsp
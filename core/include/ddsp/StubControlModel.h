@@ -0,0 +1,46 @@
+#pragma once
+
+#include "IControlModel.h"
+#include <array>
+
+namespace ddsp {
+
+/**
+ * Deterministic control model for tests and benchmarks
+ *
+ * Needs no model file and no inference library. Outputs are a smooth,
+ * repeatable function of the inputs and of a leaky recurrent state that
+ * converges to a fixed point for constant inputs, so pipeline behaviour
+ * (state carry-over, reset, timing) can be exercised anywhere.
+ *
+ * Thread-safety: NOT thread-safe. Use from single thread only.
+ */
+class StubControlModel : public IControlModel {
+public:
+    StubControlModel();
+    ~StubControlModel() override = default;
+
+    /**
+     * "Load" the stub; the path is ignored and may be empty
+     */
+    bool loadModel(const std::string& model_path, const ModelLoadOptions& options) override;
+    using IControlModel::loadModel;
+
+    void reset() override;
+    size_t stateSize() const override;
+    bool getState(float* dst, size_t size) const override;
+    bool setState(const float* src, size_t size) override;
+    bool isLoaded() const override { return model_loaded_; }
+    ControlModelBackend backend() const override { return ControlModelBackend::Stub; }
+
+protected:
+    bool invoke(const AudioFeatures& input, SynthesisControls& output) override;
+
+private:
+    bool model_loaded_;
+
+    // Leaky recurrent state, same size as the real GRU state
+    std::array<float, kGruModelStateSize> state_;
+};
+
+} // namespace ddsp
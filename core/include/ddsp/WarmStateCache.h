@@ -0,0 +1,65 @@
+#pragma once
+
+#include "IControlModel.h"
+#include <vector>
+
+namespace ddsp {
+
+/**
+ * Pre-warmed recurrent states for note onsets
+ *
+ * A voice that starts from a zeroed GRU needs several hops to settle.
+ * At load time this cache runs the model from a cold state on a grid of
+ * quantised (pitch, loudness) inputs until the state converges, and keeps
+ * the converged state per cell. A note-on restores the nearest cell so the
+ * first inference already produces settled controls.
+ *
+ * Lookups do not allocate and may run on the render thread.
+ *
+ * Thread-safety: build() is NOT thread-safe; lookup() is const.
+ */
+class WarmStateCache {
+public:
+    struct Config {
+        float min_pitch_hz = 65.41f;        // C2
+        float max_pitch_hz = 2093.0f;       // C7
+        float pitch_step_semitones = 2.0f;  // Pitch quantisation
+        int loudness_levels = 5;            // Levels over [0, 1] (>= 2)
+        int max_warmup_hops = 32;           // Upper bound per cell
+        float convergence_threshold = 1e-4f; // Max |state delta| to stop early
+    };
+
+    WarmStateCache() = default;
+
+    /**
+     * Sweep the grid through the model; leaves the model reset
+     * @return true if every cell was built
+     */
+    bool build(IControlModel& model, const Config& config);
+
+    /**
+     * Converged state for the nearest grid cell
+     * @return Pointer to stateSize() floats, or nullptr if empty
+     */
+    const float* lookup(float f0_hz, float loudness_norm) const;
+
+    bool empty() const { return states_.empty(); }
+    size_t stateSize() const { return state_size_; }
+    size_t numEntries() const { return state_size_ > 0 ? states_.size() / state_size_ : 0; }
+    size_t memoryBytes() const { return states_.size() * sizeof(float); }
+    const Config& getConfig() const { return config_; }
+
+private:
+    Config config_;
+    int num_pitches_ = 0;
+    size_t state_size_ = 0;
+    float min_midi_ = 0.0f;
+
+    // [pitch][loudness][state_size]
+    std::vector<float> states_;
+
+    int pitchIndex(float f0_hz) const;
+    int loudnessIndex(float loudness_norm) const;
+};
+
+} // namespace ddsp
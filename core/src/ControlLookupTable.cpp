@@ -0,0 +1,239 @@
+#include "ControlLookupTable.h"
+#include "InputUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace ddsp {
+
+namespace {
+
+constexpr char kLutMagic[8] = {'D', 'D', 'S', 'P', 'C', 'L', 'U', 'T'};
+constexpr uint32_t kLutVersion = 2;  // 2: source model keyed by content hash
+
+// Inverse of normalizedPitch()
+float pitchFromNorm(float f0_norm) {
+    const float midi = f0_norm * 127.0f;
+    return kFreqA4_Hz * std::pow(2.0f, (midi - kMidiNoteA4) / kSemitonesPerOctave);
+}
+
+AudioFeatures featuresAt(float f0_norm, float loudness_norm) {
+    AudioFeatures features;
+    features.f0_norm = f0_norm;
+    features.f0_hz = pitchFromNorm(f0_norm);
+    features.loudness_norm = loudness_norm;
+    features.loudness_db = denormalizeLoudness(loudness_norm);
+    return features;
+}
+
+// Grid coordinate -> lower index and fraction
+inline void gridPosition(float norm, int steps, int& index, float& frac) {
+    const float x = std::clamp(norm, 0.0f, 1.0f) * static_cast<float>(steps - 1);
+    index = std::min(static_cast<int>(x), steps - 2);
+    frac = x - static_cast<float>(index);
+}
+
+} // namespace
+
+bool ControlLookupTable::build(IControlModel& model, const Config& config) {
+    values_.clear();
+    pitch_steps_ = 0;
+    loudness_steps_ = 0;
+
+    if (!model.isLoaded() || config.pitch_steps < 2 || config.loudness_steps < 2) {
+        return false;
+    }
+    if (model.getSignature().num_harmonics != kHarmonicsSize ||
+        model.getSignature().num_noise_amps != kNoiseAmpsSize) {
+        std::cerr << "ControlLookupTable: only " << kHarmonicsSize << "-harmonic / "
+                  << kNoiseAmpsSize << "-band models can be tabulated" << std::endl;
+        return false;
+    }
+
+    pitch_steps_ = config.pitch_steps;
+    loudness_steps_ = config.loudness_steps;
+    values_.assign(static_cast<size_t>(pitch_steps_) * loudness_steps_ * kValuesPerCell, 0.0f);
+
+    SynthesisControls controls;
+    for (int p = 0; p < pitch_steps_; ++p) {
+        const float f0_norm = static_cast<float>(p) / static_cast<float>(pitch_steps_ - 1);
+        for (int l = 0; l < loudness_steps_; ++l) {
+            const float loudness_norm = static_cast<float>(l) / static_cast<float>(loudness_steps_ - 1);
+
+            model.reset();
+            if (runToSteadyState(model, featuresAt(f0_norm, loudness_norm), controls,
+                                 config.max_settle_hops, config.settle_threshold) < 0) {
+                std::cerr << "Failed to build control lookup table" << std::endl;
+                values_.clear();
+                model.reset();
+                return false;
+            }
+
+            float* dst = values_.data() + (static_cast<size_t>(p) * loudness_steps_ + l) * kValuesPerCell;
+            dst[0] = controls.amplitude;
+            std::copy(controls.harmonics.begin(), controls.harmonics.end(), dst + kAmplitudeSize);
+            std::copy(controls.noiseAmps.begin(), controls.noiseAmps.end(), dst + kAmplitudeSize + kHarmonicsSize);
+        }
+    }
+
+    model.reset();
+    model.resetTiming();
+
+    std::cout << "Control lookup table built (" << pitch_steps_ << "x" << loudness_steps_
+              << ", " << memoryBytes() / 1024 << " KB)" << std::endl;
+    return true;
+}
+
+bool ControlLookupTable::save(const std::string& path, uint64_t source_model_hash) const {
+    if (values_.empty()) {
+        return false;
+    }
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        std::cerr << "Failed to write control lookup table: " << path << std::endl;
+        return false;
+    }
+
+    const uint32_t header[] = {
+        kLutVersion,
+        static_cast<uint32_t>(pitch_steps_),
+        static_cast<uint32_t>(loudness_steps_),
+        static_cast<uint32_t>(kHarmonicsSize),
+        static_cast<uint32_t>(kNoiseAmpsSize)};
+
+    stream.write(kLutMagic, sizeof(kLutMagic));
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(&source_model_hash), sizeof(source_model_hash));
+    stream.write(reinterpret_cast<const char*>(values_.data()), static_cast<std::streamsize>(memoryBytes()));
+    return static_cast<bool>(stream);
+}
+
+bool ControlLookupTable::load(const std::string& path) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        return false;
+    }
+
+    char magic[8] = {};
+    uint32_t header[5] = {};
+    uint64_t source_model_hash = 0;
+    if (!stream.read(magic, sizeof(magic)) || std::memcmp(magic, kLutMagic, sizeof(magic)) != 0 ||
+        !stream.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        !stream.read(reinterpret_cast<char*>(&source_model_hash), sizeof(source_model_hash))) {
+        std::cerr << "Not a control lookup table: " << path << std::endl;
+        return false;
+    }
+
+    if (header[0] != kLutVersion || header[1] < 2 || header[2] < 2 ||
+        header[3] != static_cast<uint32_t>(kHarmonicsSize) ||
+        header[4] != static_cast<uint32_t>(kNoiseAmpsSize)) {
+        std::cerr << "Control lookup table does not match this build: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<float> values(static_cast<size_t>(header[1]) * header[2] * kValuesPerCell);
+    if (!stream.read(reinterpret_cast<char*>(values.data()),
+                     static_cast<std::streamsize>(values.size() * sizeof(float)))) {
+        std::cerr << "Truncated control lookup table: " << path << std::endl;
+        return false;
+    }
+
+    pitch_steps_ = static_cast<int>(header[1]);
+    loudness_steps_ = static_cast<int>(header[2]);
+    source_model_hash_ = source_model_hash;
+    values_ = std::move(values);
+    return true;
+}
+
+void ControlLookupTable::lookup(float f0_norm, float loudness_norm, SynthesisControls& output) const {
+    if (values_.empty()) {
+        output.clear();
+        return;
+    }
+
+    int p = 0, l = 0;
+    float fp = 0.0f, fl = 0.0f;
+    gridPosition(f0_norm, pitch_steps_, p, fp);
+    gridPosition(loudness_norm, loudness_steps_, l, fl);
+
+    const float* c00 = cell(p, l);
+    const float* c01 = cell(p, l + 1);
+    const float* c10 = cell(p + 1, l);
+    const float* c11 = cell(p + 1, l + 1);
+
+    const float w00 = (1.0f - fp) * (1.0f - fl);
+    const float w01 = (1.0f - fp) * fl;
+    const float w10 = fp * (1.0f - fl);
+    const float w11 = fp * fl;
+
+    auto blend = [&](int i) {
+        return w00 * c00[i] + w01 * c01[i] + w10 * c10[i] + w11 * c11[i];
+    };
+
+    output.amplitude = blend(0);
+    for (int h = 0; h < kHarmonicsSize; ++h) {
+        output.harmonics[h] = blend(kAmplitudeSize + h);
+    }
+    for (int n = 0; n < kNoiseAmpsSize; ++n) {
+        output.noiseAmps[n] = blend(kAmplitudeSize + kHarmonicsSize + n);
+    }
+}
+
+ControlLookupTable::Quality ControlLookupTable::measureQuality(IControlModel& reference, int probes_per_axis) const {
+    Quality quality;
+    if (values_.empty() || !reference.isLoaded() || probes_per_axis < 1) {
+        return quality;
+    }
+
+    const Config settle;
+    SynthesisControls live;
+    SynthesisControls table;
+    double sum_squared = 0.0;
+    size_t count = 0;
+
+    auto accumulate = [&](float a, float b) {
+        const float error = std::abs(a - b);
+        quality.max_abs_error = std::max(quality.max_abs_error, error);
+        sum_squared += static_cast<double>(error) * error;
+        ++count;
+    };
+
+    for (int i = 0; i < probes_per_axis; ++i) {
+        const float f0_norm = (static_cast<float>(i) + 0.5f) / static_cast<float>(probes_per_axis);
+        for (int j = 0; j < probes_per_axis; ++j) {
+            const float loudness_norm = (static_cast<float>(j) + 0.5f) / static_cast<float>(probes_per_axis);
+
+            reference.reset();
+            if (runToSteadyState(reference, featuresAt(f0_norm, loudness_norm), live,
+                                 settle.max_settle_hops, settle.settle_threshold) < 0) {
+                continue;
+            }
+            lookup(f0_norm, loudness_norm, table);
+
+            accumulate(live.amplitude, table.amplitude);
+            for (int h = 0; h < kHarmonicsSize; ++h) {
+                accumulate(live.harmonics[h], table.harmonics[h]);
+            }
+            for (int n = 0; n < kNoiseAmpsSize; ++n) {
+                accumulate(live.noiseAmps[n], table.noiseAmps[n]);
+            }
+
+            constexpr float kFloor = 1e-7f;
+            const float amplitude_db = 20.0f * std::abs(std::log10(std::max(table.amplitude, kFloor) /
+                                                                   std::max(live.amplitude, kFloor)));
+            quality.max_amplitude_error_db = std::max(quality.max_amplitude_error_db, amplitude_db);
+            ++quality.probes;
+        }
+    }
+
+    reference.reset();
+    if (count > 0) {
+        quality.rms_error = static_cast<float>(std::sqrt(sum_squared / static_cast<double>(count)));
+    }
+    return quality;
+}
+
+} // namespace ddsp
@@ -7,6 +7,52 @@ namespace ddsp {
 
 namespace {
     constexpr float kTwoPi = 2.0f * 3.14159265358979323846f;
+
+    // Kernels take the harmonic count as a template argument for the common
+    // model shapes so the loops unroll and vectorise; 0 = runtime count.
+
+    template <int NumHarmonics>
+    void normalizeKernel(float* distribution, const float* series, int num_harmonics,
+                         float f0_hz, float nyquist, float amplitude) {
+        const int count = NumHarmonics > 0 ? NumHarmonics : num_harmonics;
+
+        // Remove harmonics above Nyquist, then normalize so coefficients sum to 1
+        float total = 0.0f;
+        for (int i = 0; i < count; ++i) {
+            if (series[i] * f0_hz >= nyquist) {
+                distribution[i] = 0.0f;
+            }
+            total += distribution[i];
+        }
+
+        // Scale by amplitude
+        const float scale = total != 0.0f ? amplitude / total : amplitude;
+        for (int i = 0; i < count; ++i) {
+            distribution[i] *= scale;
+        }
+    }
+
+    // Amplitudes follow the midway lerp from start[h] to end[h], computed
+    // in place rather than stored per harmonic and sample
+    template <int NumHarmonics>
+    void accumulateKernel(const float* phases, const float* start, const float* end, const float* ramp,
+                          int num_harmonics, int num_samples, float* output) {
+        const int count = NumHarmonics > 0 ? NumHarmonics : num_harmonics;
+        const int half = num_samples / 2;
+
+        for (int h = 0; h < count; ++h) {
+            const float harmonic_order = static_cast<float>(h + 1);  // 1, 2, 3, ...
+            const float first = start[h];
+            const float last = end[h];
+
+            for (int s = 0; s < half; ++s) {
+                output[s] += std::sin(phases[s] * harmonic_order) * (first + ramp[s] * (last - first));
+            }
+            for (int s = half; s < num_samples; ++s) {
+                output[s] += std::sin(phases[s] * harmonic_order) * last;
+            }
+        }
+    }
 }
 
 HarmonicSynthesizer::HarmonicSynthesizer(int num_harmonics, int num_output_samples, float sample_rate)
@@ -22,18 +68,24 @@ HarmonicSynthesizer::HarmonicSynthesizer(int num_harmonics, int num_output_sampl
 
     // Allocate working buffers
     previous_harmonic_distribution_.resize(num_harmonics_, 0.0f);
-    frame_frequencies_.resize(num_harmonics_);
+    start_harmonic_distribution_.resize(num_harmonics_, 0.0f);
     frequency_envelope_.resize(num_output_samples_);
     phases_.resize(num_output_samples_);
     render_buffer_.resize(num_output_samples_);
 
-    // Allocate 2D harmonic amplitudes [num_harmonics][num_output_samples]
-    harmonic_amplitudes_.resize(num_harmonics_);
-    for (int i = 0; i < num_harmonics_; ++i) {
-        harmonic_amplitudes_[i].resize(num_output_samples_, 0.0f);
+    // Same positions interpolateLinearly() uses for the first half
+    ramp_.resize(num_output_samples_ / 2);
+    for (size_t i = 0; i < ramp_.size(); ++i) {
+        ramp_[i] = static_cast<float>(i) / static_cast<float>(ramp_.size());
     }
 }
 
+size_t HarmonicSynthesizer::getMemoryBytes() const {
+    return (harmonic_series_.capacity() + previous_harmonic_distribution_.capacity() +
+            start_harmonic_distribution_.capacity() + frequency_envelope_.capacity() + phases_.capacity() +
+            ramp_.capacity() + render_buffer_.capacity()) * sizeof(float);
+}
+
 void HarmonicSynthesizer::reset() {
     previous_phase_ = 0.0f;
     previous_f0_.reset();
@@ -42,6 +94,24 @@ void HarmonicSynthesizer::reset() {
     std::fill(render_buffer_.begin(), render_buffer_.end(), 0.0f);
 }
 
+void HarmonicSynthesizer::getState(State& state) const {
+    state.phase = previous_phase_;
+    state.f0 = previous_f0_;
+    state.amplitude = previous_amplitude_;
+    state.harmonic_distribution.assign(
+        previous_harmonic_distribution_.begin(), previous_harmonic_distribution_.end());
+}
+
+void HarmonicSynthesizer::setState(const State& state) {
+    previous_phase_ = state.phase;
+    previous_f0_ = state.f0;
+    previous_amplitude_ = state.amplitude;
+    if (state.harmonic_distribution.size() == previous_harmonic_distribution_.size()) {
+        std::copy(state.harmonic_distribution.begin(), state.harmonic_distribution.end(),
+                  previous_harmonic_distribution_.begin());
+    }
+}
+
 const std::vector<float>& HarmonicSynthesizer::render(
     std::vector<float>& harmonic_distribution,
     float amplitude,
@@ -56,45 +126,35 @@ const std::vector<float>& HarmonicSynthesizer::render(
     midwayLerp(prev_f0, f0_hz, frequency_envelope_);
     previous_f0_ = f0_hz;
 
-    // Interpolate each harmonic's amplitude
-    for (int i = 0; i < num_harmonics_; ++i) {
-        midwayLerp(previous_harmonic_distribution_[i], harmonic_distribution[i], harmonic_amplitudes_[i]);
-    }
-    previous_harmonic_distribution_ = harmonic_distribution;
+    // Each harmonic's amplitude ramps from the previous frame (applied in synthesizeHarmonics)
+    std::copy(previous_harmonic_distribution_.begin(), previous_harmonic_distribution_.end(),
+              start_harmonic_distribution_.begin());
+    std::copy_n(harmonic_distribution.begin(), num_harmonics_, previous_harmonic_distribution_.begin());
 
     return synthesizeHarmonics();
 }
 
+void HarmonicSynthesizer::advancePhase(float f0_hz) {
+    float prev_f0 = previous_f0_.value_or(f0_hz);
+    midwayLerp(prev_f0, f0_hz, frequency_envelope_);
+    previous_f0_ = f0_hz;
+
+    integratePhase();
+}
+
 void HarmonicSynthesizer::normalizeHarmonicDistribution(
     std::vector<float>& harmonic_distribution,
     float amplitude,
     float f0_hz)
 {
-    // Calculate frequencies for each harmonic: f0 * [1, 2, 3, ..., num_harmonics]
-    for (int i = 0; i < num_harmonics_; ++i) {
-        frame_frequencies_[i] = harmonic_series_[i] * f0_hz;
-    }
-
-    // Remove harmonics above Nyquist (sample_rate / 2)
-    float nyquist = sample_rate_ / 2.0f;
-    for (int i = 0; i < num_harmonics_; ++i) {
-        if (frame_frequencies_[i] >= nyquist) {
-            harmonic_distribution[i] = 0.0f;
-        }
-    }
-
-    // Normalize so coefficients sum to 1
-    float total = std::accumulate(harmonic_distribution.begin(), harmonic_distribution.end(), 0.0f);
-    if (total != 0.0f) {
-        float scale = 1.0f / total;
-        for (int i = 0; i < num_harmonics_; ++i) {
-            harmonic_distribution[i] *= scale;
-        }
-    }
-
-    // Scale by amplitude
-    for (int i = 0; i < num_harmonics_; ++i) {
-        harmonic_distribution[i] *= amplitude;
+    const float nyquist = sample_rate_ / 2.0f;
+    float* distribution = harmonic_distribution.data();
+    const float* series = harmonic_series_.data();
+
+    switch (num_harmonics_) {
+        case 60: normalizeKernel<60>(distribution, series, num_harmonics_, f0_hz, nyquist, amplitude); break;
+        case 64: normalizeKernel<64>(distribution, series, num_harmonics_, f0_hz, nyquist, amplitude); break;
+        default: normalizeKernel<0>(distribution, series, num_harmonics_, f0_hz, nyquist, amplitude); break;
     }
 }
 
@@ -122,7 +182,7 @@ void HarmonicSynthesizer::interpolateLinearly(
     }
 }
 
-const std::vector<float>& HarmonicSynthesizer::synthesizeHarmonics() {
+void HarmonicSynthesizer::integratePhase() {
     // Convert Hz to radians per sample
     for (int i = 0; i < num_output_samples_; ++i) {
         frequency_envelope_[i] *= kTwoPi / sample_rate_;
@@ -138,19 +198,25 @@ const std::vector<float>& HarmonicSynthesizer::synthesizeHarmonics() {
 
     // Wrap and store phase for next frame
     previous_phase_ = std::fmod(phases_.back(), kTwoPi);
+}
+
+const std::vector<float>& HarmonicSynthesizer::synthesizeHarmonics() {
+    integratePhase();
 
     // Clear output buffer
     std::fill(render_buffer_.begin(), render_buffer_.end(), 0.0f);
 
     // Generate sinusoids for each harmonic and accumulate
-    for (int h = 0; h < num_harmonics_; ++h) {
-        int harmonic_order = h + 1;  // 1, 2, 3, ...
-
-        for (int s = 0; s < num_output_samples_; ++s) {
-            float phase = phases_[s] * harmonic_order;
-            float sinusoid = std::sin(phase) * harmonic_amplitudes_[h][s];
-            render_buffer_[s] += sinusoid;
-        }
+    const float* phases = phases_.data();
+    const float* start = start_harmonic_distribution_.data();
+    const float* end = previous_harmonic_distribution_.data();
+    const float* ramp = ramp_.data();
+    float* output = render_buffer_.data();
+
+    switch (num_harmonics_) {
+        case 60: accumulateKernel<60>(phases, start, end, ramp, num_harmonics_, num_output_samples_, output); break;
+        case 64: accumulateKernel<64>(phases, start, end, ramp, num_harmonics_, num_output_samples_, output); break;
+        default: accumulateKernel<0>(phases, start, end, ramp, num_harmonics_, num_output_samples_, output); break;
     }
 
     return render_buffer_;
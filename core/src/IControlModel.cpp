@@ -0,0 +1,225 @@
+#include "IControlModel.h"
+#include "LutControlModel.h"
+#include "NativeControlModel.h"
+#include "StubControlModel.h"
+
+#ifdef DDSP_WITH_TFLITE
+#include "PredictControlsModel.h"
+#endif
+
+#ifdef DDSP_WITH_ONNXRUNTIME
+#include "OnnxControlModel.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace ddsp {
+
+bool IControlModel::loadModelFromBlob(std::shared_ptr<const ModelBlob> blob, const ModelLoadOptions& options) {
+    if (!blob || blob->path().empty()) {
+        std::cerr << "Backend " << controlModelBackendName(backend())
+                  << " cannot load from an in-memory model" << std::endl;
+        return false;
+    }
+    return loadModel(blob->path(), options);
+}
+
+bool IControlModel::call(const AudioFeatures& input, SynthesisControls& output) {
+    const ModelSignature& signature = getSignature();
+    if (!output.matches(signature)) {
+        output.resize(signature.num_harmonics, signature.num_noise_amps);
+    }
+
+    setLastError(InferenceError::None);
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = invoke(input, output);
+    auto end = std::chrono::steady_clock::now();
+
+    if (!ok && getLastError() == InferenceError::None) {
+        setLastError(InferenceError::Unknown);
+    }
+
+    double elapsed_us = std::chrono::duration<double, std::micro>(end - start).count();
+
+    timing_.num_calls++;
+    if (!ok) {
+        timing_.num_failures++;
+    }
+    timing_.last_us = elapsed_us;
+    timing_.mean_us += (elapsed_us - timing_.mean_us) / static_cast<double>(timing_.num_calls);
+    timing_.max_us = std::max(timing_.max_us, elapsed_us);
+
+    return ok;
+}
+
+void IControlModel::warmUp(int invocations) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Mid-range controls exercise the whole graph
+    AudioFeatures features;
+    features.f0_norm = 0.5f;
+    features.loudness_norm = 0.5f;
+    SynthesisControls controls(signature_.num_harmonics, signature_.num_noise_amps);
+
+    for (int i = 0; i < invocations; ++i) {
+        if (!invoke(features, controls)) {
+            break;
+        }
+    }
+    reset();
+
+    auto end = std::chrono::steady_clock::now();
+    startup_profile_.warmup_ms = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int runToSteadyState(IControlModel& model, const AudioFeatures& input, SynthesisControls& output,
+                     int max_hops, float threshold) {
+    const size_t state_size = model.stateSize();
+    std::vector<float> previous(state_size);
+    std::vector<float> current(state_size);
+
+    int hops = 0;
+    while (hops < max_hops) {
+        model.getState(previous.data(), state_size);
+        if (!model.call(input, output)) {
+            return -1;
+        }
+        ++hops;
+        model.getState(current.data(), state_size);
+
+        float max_delta = 0.0f;
+        for (size_t i = 0; i < state_size; ++i) {
+            max_delta = std::max(max_delta, std::abs(current[i] - previous[i]));
+        }
+        if (max_delta < threshold) {
+            break;
+        }
+    }
+    return hops;
+}
+
+bool readModelSignature(const std::string& path, ModelSignature& signature) {
+    std::ifstream stream(path);
+    if (!stream) {
+        return false;
+    }
+
+    std::pair<const char*, std::string*> fields[] = {
+        {"f0_input", &signature.f0_input},
+        {"loudness_input", &signature.loudness_input},
+        {"state_input", &signature.state_input},
+        {"amplitude_output", &signature.amplitude_output},
+        {"harmonics_output", &signature.harmonics_output},
+        {"noise_output", &signature.noise_output},
+        {"state_output", &signature.state_output}};
+
+    auto trim = [](std::string text) {
+        const auto first = text.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            return std::string();
+        }
+        const auto last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    };
+
+    std::string line;
+    while (std::getline(stream, line)) {
+        line = line.substr(0, line.find('#'));
+        const auto equals = line.find('=');
+        if (equals == std::string::npos) {
+            continue;
+        }
+        const std::string key = trim(line.substr(0, equals));
+        const std::string value = trim(line.substr(equals + 1));
+        for (auto& [name, field] : fields) {
+            if (key == name && !value.empty()) {
+                *field = value;
+            }
+        }
+    }
+    return true;
+}
+
+bool isControlModelBackendAvailable(ControlModelBackend backend) {
+    switch (backend) {
+        case ControlModelBackend::Default:
+            return resolveControlModelBackend(backend) != ControlModelBackend::Default;
+        case ControlModelBackend::TFLite:
+#ifdef DDSP_WITH_TFLITE
+            return true;
+#else
+            return false;
+#endif
+        case ControlModelBackend::OnnxRuntime:
+#ifdef DDSP_WITH_ONNXRUNTIME
+            return true;
+#else
+            return false;
+#endif
+        case ControlModelBackend::Native:
+        case ControlModelBackend::Stub:
+        case ControlModelBackend::LookupTable:
+            return true;
+    }
+    return false;
+}
+
+ControlModelBackend resolveControlModelBackend(ControlModelBackend backend) {
+    if (backend != ControlModelBackend::Default) {
+        return backend;
+    }
+#if defined(DDSP_WITH_TFLITE)
+    return ControlModelBackend::TFLite;
+#elif defined(DDSP_WITH_ONNXRUNTIME)
+    return ControlModelBackend::OnnxRuntime;
+#else
+    return ControlModelBackend::Native;
+#endif
+}
+
+const char* controlModelBackendName(ControlModelBackend backend) {
+    switch (backend) {
+        case ControlModelBackend::Default:     return "default";
+        case ControlModelBackend::TFLite:      return "tflite";
+        case ControlModelBackend::OnnxRuntime: return "onnxruntime";
+        case ControlModelBackend::Native:      return "native";
+        case ControlModelBackend::Stub:        return "stub";
+        case ControlModelBackend::LookupTable: return "lut";
+    }
+    return "unknown";
+}
+
+std::unique_ptr<IControlModel> createControlModel(ControlModelBackend backend) {
+    switch (resolveControlModelBackend(backend)) {
+        case ControlModelBackend::TFLite:
+#ifdef DDSP_WITH_TFLITE
+            return std::make_unique<PredictControlsModel>();
+#else
+            return nullptr;
+#endif
+        case ControlModelBackend::OnnxRuntime:
+#ifdef DDSP_WITH_ONNXRUNTIME
+            return std::make_unique<OnnxControlModel>();
+#else
+            return nullptr;
+#endif
+        case ControlModelBackend::Native:
+            return std::make_unique<NativeControlModel>();
+        case ControlModelBackend::Stub:
+            return std::make_unique<StubControlModel>();
+        case ControlModelBackend::LookupTable:
+            return std::make_unique<LutControlModel>();
+        case ControlModelBackend::Default:
+            break;
+    }
+    return nullptr;
+}
+
+} // namespace ddsp
@@ -1,37 +1,155 @@
 #include "InferencePipeline.h"
+#include "RealtimeChecker.h"
+#include "RenderPool.h"
 #include <iostream>
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cerrno>
+#if defined(__linux__)
+#include <time.h>
+#endif
 
 namespace ddsp {
 
+namespace {
+
+std::unique_ptr<IControlModel> createModel(ControlModelBackend backend, const ModelLoadOptions& options) {
+    auto model = createControlModel(backend);
+    if (!model) {
+        std::cerr << "Inference backend not available in this build: "
+                  << controlModelBackendName(resolveControlModelBackend(backend)) << std::endl;
+        return nullptr;
+    }
+    if (options.inference_cache_bytes > 0) {
+        // A cache miss allocates an entry, which the render thread must not do
+        std::cerr << "inference_cache_bytes is ignored in real time; use OfflineRenderer" << std::endl;
+    }
+    return model;
+}
+
+// Sleep until an absolute steady_clock deadline, so per-wake overhead and
+// oversleep do not accumulate the way relative sleeps do
+void sleepUntil(std::chrono::steady_clock::time_point deadline) {
+#if defined(__linux__)
+    // libstdc++/libc++ steady_clock is CLOCK_MONOTONIC on Linux
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(deadline);
+#endif
+}
+
+size_t bufferBytes(const juce::AudioBuffer<float>& buffer) {
+    return static_cast<size_t>(buffer.getNumChannels()) * static_cast<size_t>(buffer.getNumSamples()) *
+           sizeof(float);
+}
+
+size_t controlsBytes(const SynthesisControls& controls) {
+    return (controls.harmonics.capacity() + controls.noiseAmps.capacity()) * sizeof(float);
+}
+
+// Park an object in the first free slot; the slots are sized so the
+// fallback delete (reported by RealtimeChecker) never runs
+template <typename T, size_t N>
+void retireInto(std::array<std::atomic<T*>, N>& slots, T* object) {
+    if (!object) {
+        return;
+    }
+    for (auto& slot : slots) {
+        T* expected = nullptr;
+        if (slot.compare_exchange_strong(expected, object, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+    delete object;
+}
+
+template <typename T, size_t N>
+void freeSlots(std::array<std::atomic<T*>, N>& slots) {
+    for (auto& slot : slots) {
+        delete slot.exchange(nullptr, std::memory_order_acq_rel);
+    }
+}
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
 InferencePipeline::InferencePipeline()
     : sample_rate_(48000.0)
     , samples_per_block_(512)
     , user_frame_size_(0)
     , user_hop_size_(0)
+    , output_capacity_(0)
+    , audio_input_enabled_(false)
     , model_ready_(false)
-    , f0_hz_(440.0f)
-    , loudness_norm_(0.5f)
-    , pitch_shift_semitones_(0.0f)
-    , harmonic_gain_(1.0f)
-    , noise_gain_(1.0f)
+    , event_fifo_(kEventQueueSize)
+    , infer_position_(0)
+    , event_f0_hz_(0.0f)
+    , event_loudness_norm_(0.0f)
+    , event_f0_revision_(0)
+    , event_loudness_revision_(0)
+    , event_values_valid_(false)
+    , host_position_(0)
     , current_pitch_(0.0f)
     , current_rms_(0.0f)
+    , steady_state_enabled_(false)
+    , inference_interval_(1)
+    , hops_until_inference_(0)
+    , ramp_length_(1)
+    , ramp_position_(0)
+    , snap_controls_(true)
+    , rendered_hops_(0)
+    , model_invocations_(0)
+    , load_state_(ModelLoadState::Idle)
+    , pending_(nullptr)
+    , staged_shape_(nullptr)
+    , crossfade_hops_(0)
+    , crossfade_position_(0)
+    , warm_cache_enabled_(false)
+    , note_on_pending_(false)
+    , pipelined_(false)
+    , control_fifo_(kControlQueueSize)
+    , target_fill_samples_(0)
+    , latency_mode_(LatencyMode::Balanced)
+    , scheduler_wakeups_(0)
+    , scheduler_hops_(0)
+    , scheduler_catch_up_hops_(0)
+    , scheduler_idle_wakeups_(0)
+    , scheduler_underruns_(0)
+    , scheduler_fill_samples_(0)
+    , scheduler_start_ns_(0)
+    , scheduler_start_fill_(0)
+    , pull_mode_(false)
+    , render_pool_(nullptr)
+    , active_pool_(nullptr)
+    , inference_failures_(0)
+    , last_inference_error_(InferenceError::None)
     , should_run_(false)
 {
-    // Create model
-    model_ = std::make_unique<PredictControlsModel>();
-
     // Create synthesizers at model sample rate
     harmonic_synth_ = std::make_unique<HarmonicSynthesizer>(
         kHarmonicsSize, kModelHopSize, kModelSampleRate_Hz);
     noise_synth_ = std::make_unique<NoiseSynthesizer>(
         kNoiseAmpsSize, kModelHopSize);
+
+    // Sized once so note-on snapshots never allocate
+    harmonic_synth_->getState(note_on_harmonic_state_);
 }
 
 InferencePipeline::~InferencePipeline() {
     stopTimer();
+    collectRetiredModels();
+    delete pending_.exchange(nullptr);
+    delete staged_shape_.exchange(nullptr);
     releaseResources();
 }
 
@@ -43,18 +161,38 @@ void InferencePipeline::prepareToPlay(double sample_rate, int samples_per_block)
     user_frame_size_ = static_cast<int>(std::ceil(sample_rate * kModelFrameSize / kModelSampleRate_Hz));
     user_hop_size_ = static_cast<int>(sample_rate * kModelHopSize / kModelSampleRate_Hz);
 
-    // Create ring buffers
-    input_fifo_ = std::make_unique<juce::AbstractFifo>(kRingBufferSize);
-    output_fifo_ = std::make_unique<juce::AbstractFifo>(kRingBufferSize);
-    input_ring_buffer_.setSize(1, kRingBufferSize);
-    output_ring_buffer_.setSize(1, kRingBufferSize);
+    // Output FIFO: the deepest watermark plus the hop that crosses it
+    const int watermark = std::max(watermarkForMode(latency_mode_.load(std::memory_order_relaxed)),
+                                   target_fill_samples_.load(std::memory_order_relaxed));
+    output_capacity_ = std::min(watermark + user_hop_size_ + 1, kRingBufferSize);
+    output_fifo_ = std::make_unique<juce::AbstractFifo>(output_capacity_);
+    output_ring_buffer_.setSize(1, output_capacity_);
+
+    // Input path only when audio input is used (synth mode never reads it)
+    if (audio_input_enabled_) {
+        const int input_capacity = std::min(user_frame_size_ + samples_per_block + 1, kRingBufferSize);
+        input_fifo_ = std::make_unique<juce::AbstractFifo>(input_capacity);
+        input_ring_buffer_.setSize(1, input_capacity);
+        model_input_buffer_.setSize(1, user_frame_size_);
+        resampled_model_input_buffer_.setSize(1, kModelFrameSize);
+    } else {
+        input_fifo_.reset();
+        input_ring_buffer_ = juce::AudioBuffer<float>();
+        model_input_buffer_ = juce::AudioBuffer<float>();
+        resampled_model_input_buffer_ = juce::AudioBuffer<float>();
+    }
 
     // Allocate working buffers
-    model_input_buffer_.setSize(1, user_frame_size_);
-    resampled_model_input_buffer_.setSize(1, kModelFrameSize);
     synthesis_buffer_.setSize(1, kModelHopSize);
     resampled_model_output_buffer_.setSize(1, user_hop_size_);
 
+    // Polyphase tables when every hop maps to exactly user_hop_size_ samples
+    const bool whole_hop = std::abs(sample_rate * kModelHopSize / kModelSampleRate_Hz - user_hop_size_) < 1e-9;
+    if (!whole_hop ||
+        !output_resampler_.prepare(kModelSampleRate_Hz, sample_rate, kModelHopSize, resampler_quality_)) {
+        output_resampler_ = PolyphaseResampler();
+    }
+
     // Reset everything
     reset();
 }
@@ -63,22 +201,486 @@ void InferencePipeline::releaseResources() {
     model_ready_ = false;
 }
 
-bool InferencePipeline::loadModel(const std::string& model_path, int num_threads) {
-    if (!model_->loadModel(model_path, num_threads)) {
+bool InferencePipeline::loadModel(const std::string& model_path, int num_threads, ControlModelBackend backend) {
+    ModelLoadOptions options;
+    options.num_threads = num_threads;
+    return loadModel(model_path, options, backend);
+}
+
+bool InferencePipeline::loadModel(const std::string& model_path, const ModelLoadOptions& options,
+                                  ControlModelBackend backend) {
+    // Synchronous load replaces the model in place; call before startTimer()
+    // or use loadModelAsync() while rendering
+    releaseModel();
+
+    auto model = createModel(backend, options);
+    if (!model) {
+        return false;
+    }
+
+    if (!model->loadModel(model_path, options)) {
         std::cerr << "Failed to load DDSP model" << std::endl;
         return false;
     }
 
+    return adoptModel(std::move(model));
+}
+
+bool InferencePipeline::loadModelFromMemory(const void* data, size_t size, const ModelLoadOptions& options,
+                                            ControlModelBackend backend) {
+    releaseModel();
+
+    auto model = createModel(backend, options);
+    if (!model) {
+        return false;
+    }
+
+    if (!model->loadModelFromMemory(data, size, options)) {
+        std::cerr << "Failed to load DDSP model from memory" << std::endl;
+        return false;
+    }
+
+    return adoptModel(std::move(model));
+}
+
+bool InferencePipeline::adoptModel(std::unique_ptr<IControlModel> model) {
+    releaseModel();  // Previous model (if any) is freed here
+
+    if (!model || !model->isLoaded() || !configureForModel(*model)) {
+        return false;
+    }
+
+    model_ = std::move(model);
+    model_->reset();
+    warm_cache_ = buildWarmStateCache(*model_, warm_cache_enabled_, warm_cache_config_);
+    steady_state_.prepare(*model_);
+
     model_ready_ = true;
     return true;
 }
 
+std::unique_ptr<IControlModel> InferencePipeline::releaseModel() {
+    adoptStagedShape();  // Render thread is stopped: finish a half-done shape change
+    collectRetiredModels();
+    delete pending_.exchange(nullptr, std::memory_order_acq_rel);
+
+    model_ready_ = false;
+    fading_model_.reset();
+    warm_cache_.reset();
+    return std::move(model_);
+}
+
+void InferencePipeline::loadModelAsync(const std::string& model_path, const ModelLoadOptions& options,
+                                       ControlModelBackend backend, int crossfade_hops) {
+    startAsyncLoad(model_path, nullptr, options, backend, crossfade_hops);
+}
+
+void InferencePipeline::loadModelAsync(std::shared_ptr<const ModelBlob> blob, const ModelLoadOptions& options,
+                                       ControlModelBackend backend, int crossfade_hops) {
+    const std::string model_path = blob && !blob->path().empty() ? blob->path() : "<memory>";
+    startAsyncLoad(model_path, std::move(blob), options, backend, crossfade_hops);
+}
+
+void InferencePipeline::startAsyncLoad(const std::string& model_path, std::shared_ptr<const ModelBlob> blob,
+                                       const ModelLoadOptions& options, ControlModelBackend backend,
+                                       int crossfade_hops) {
+    collectRetiredModels();
+
+    // Drop a loaded model that never reached a hop boundary
+    delete pending_.exchange(nullptr, std::memory_order_acq_rel);
+
+    load_state_.store(ModelLoadState::Loading, std::memory_order_release);
+
+    const bool warm_cache_enabled = warm_cache_enabled_;
+    const WarmStateCache::Config warm_cache_config = warm_cache_config_;
+
+    loader_thread_ = std::thread([this, model_path, blob, options, backend, crossfade_hops,
+                                  warm_cache_enabled, warm_cache_config]() {
+        auto model = createModel(backend, options);
+        if (!model) {
+            load_state_.store(ModelLoadState::Failed, std::memory_order_release);
+            return;
+        }
+
+        const bool loaded = blob ? model->loadModelFromBlob(blob, options) : model->loadModel(model_path, options);
+        if (!loaded) {
+            std::cerr << "Failed to load DDSP model asynchronously: " << model_path << std::endl;
+            load_state_.store(ModelLoadState::Failed, std::memory_order_release);
+            return;
+        }
+
+        if (!isSupportedShape(model->getSignature())) {
+            load_state_.store(ModelLoadState::Failed, std::memory_order_release);
+            return;
+        }
+
+        // Whether the shape changes is only known at the swap, so the state
+        // for it is always built here; resizing on the render thread would allocate
+        auto pending = std::make_unique<PendingModel>();
+        pending->shape = buildShapeState(*model);
+        pending->warm_cache = buildWarmStateCache(*model, warm_cache_enabled, warm_cache_config);
+        pending->crossfade_hops = std::max(crossfade_hops, 0);
+        pending->model = std::move(model);
+
+        load_state_.store(ModelLoadState::Pending, std::memory_order_release);
+        pending_.store(pending.release(), std::memory_order_release);
+    });
+}
+
+void InferencePipeline::collectRetiredModels() {
+    if (loader_thread_.joinable()) {
+        loader_thread_.join();
+    }
+    freeRetiredModels();
+}
+
+void InferencePipeline::freeRetiredModels() {
+    freeSlots(retired_models_);
+    freeSlots(retired_pending_);
+    freeSlots(retired_shapes_);
+}
+
+void InferencePipeline::swapPendingModel() {
+    // One shape change in flight: wait until the synthesis stage took the last one
+    if (staged_shape_.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    PendingModel* pending = pending_.exchange(nullptr, std::memory_order_acq_rel);
+    if (!pending) {
+        return;
+    }
+
+    const bool shape_changed = !model_controls_.matches(pending->model->getSignature());
+    if (shape_changed) {
+        // Inference half now; synthesizers when the first hop of this shape is synthesized
+        ShapeState* shape = pending->shape.release();
+        std::swap(model_controls_, shape->model_controls);
+        std::swap(synthesis_input_, shape->synthesis_input);
+        std::swap(ramp_start_controls_, shape->ramp_start_controls);
+        std::swap(fading_controls_, shape->fading_controls);
+        steady_state_.swapBuffers(shape->steady_state);
+        snap_controls_ = true;
+        staged_shape_.store(shape, std::memory_order_release);
+    }
+
+    // A crossfade still in progress ends here; its old model is retired
+    std::unique_ptr<IControlModel> outgoing = std::move(fading_model_);
+    const int crossfade_hops = shape_changed ? 0 : pending->crossfade_hops;
+
+    if (crossfade_hops > 0 && model_ && model_ready_.load(std::memory_order_acquire)) {
+        if (outgoing) {
+            retireModel(std::move(outgoing));
+        }
+        fading_model_ = std::move(model_);
+        crossfade_hops_ = crossfade_hops;
+        crossfade_position_ = 0;
+    } else {
+        if (outgoing) {
+            retireModel(std::move(outgoing));
+        }
+        if (model_) {
+            retireModel(std::move(model_));
+        }
+        crossfade_hops_ = 0;
+    }
+
+    model_ = std::move(pending->model);
+
+    // The cache belongs to the model it was built from; the old one leaves with the bundle
+    std::swap(warm_cache_, pending->warm_cache);
+    retireInto(retired_pending_, pending);
+
+    // Infer with the new model on this hop, ramping from the old controls
+    steady_state_.invalidate();
+    hops_until_inference_ = 0;
+    model_ready_.store(true, std::memory_order_release);
+    load_state_.store(ModelLoadState::Swapped, std::memory_order_release);
+}
+
+void InferencePipeline::adoptStagedShape() {
+    ShapeState* shape = staged_shape_.exchange(nullptr, std::memory_order_acq_rel);
+    if (!shape) {
+        return;
+    }
+    std::swap(harmonic_synth_, shape->harmonic_synth);
+    std::swap(noise_synth_, shape->noise_synth);
+    std::swap(note_on_harmonic_state_, shape->note_on_harmonic_state);
+    std::swap(queued_controls_, shape->queued_controls);
+    retireInto(retired_shapes_, shape);
+}
+
+void InferencePipeline::retireModel(std::unique_ptr<IControlModel> model) {
+    // Freeing an interpreter is slow; leave it to the timer thread between
+    // wake-ups or to the control thread (pull mode: the next load or destruction)
+    retireInto(retired_models_, model.release());
+}
+
+bool InferencePipeline::updateControls() {
+    if (hops_until_inference_ <= 0) {
+        const int interval = inference_interval_.load(std::memory_order_relaxed);
+        if (interval > 1 && !snap_controls_) {
+            ramp_start_controls_.copyFrom(model_controls_);
+        }
+
+        if (!computeControls()) {
+            return false;
+        }
+
+        ramp_length_ = snap_controls_ ? 1 : interval;
+        ramp_position_ = 0;
+        hops_until_inference_ = interval;
+        snap_controls_ = false;
+    }
+
+    --hops_until_inference_;
+    ++ramp_position_;
+
+    // Copy keeps model_controls_ intact; the harmonic synth normalizes in place
+    if (ramp_length_ <= 1) {
+        synthesis_input_.copyFrom(model_controls_);
+    } else {
+        const float w = static_cast<float>(ramp_position_) / static_cast<float>(ramp_length_);
+        synthesis_input_.amplitude = lerp(ramp_start_controls_.amplitude, model_controls_.amplitude, w);
+        for (size_t i = 0; i < synthesis_input_.harmonics.size(); ++i) {
+            synthesis_input_.harmonics[i] = lerp(ramp_start_controls_.harmonics[i], model_controls_.harmonics[i], w);
+        }
+        for (size_t i = 0; i < synthesis_input_.noiseAmps.size(); ++i) {
+            synthesis_input_.noiseAmps[i] = lerp(ramp_start_controls_.noiseAmps[i], model_controls_.noiseAmps[i], w);
+        }
+    }
+
+    // Pitch is an input, not a model output: never decimate it
+    synthesis_input_.f0_hz = predict_controls_input_.f0_hz;
+    rendered_hops_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool InferencePipeline::computeControls() {
+    // Never skip while two models are being blended
+    const bool detect = steady_state_enabled_.load(std::memory_order_relaxed) && !fading_model_;
+
+    if (detect && steady_state_.shouldSkip(predict_controls_input_)) {
+        model_controls_.f0_hz = predict_controls_input_.f0_hz;
+        return true;
+    }
+
+    if (!runInference()) {
+        return false;
+    }
+
+    if (detect) {
+        steady_state_.update(*model_, predict_controls_input_, model_controls_);
+    }
+    return true;
+}
+
+bool InferencePipeline::runInference() {
+    model_invocations_.fetch_add(1, std::memory_order_relaxed);
+    if (!model_->call(predict_controls_input_, model_controls_)) {
+        return false;
+    }
+
+    if (!fading_model_) {
+        return true;
+    }
+
+    // Linear crossfade of the control streams; the old model keeps
+    // its GRU state advancing so its half of the fade stays coherent
+    if (fading_model_->call(predict_controls_input_, fading_controls_)) {
+        const float w = static_cast<float>(crossfade_position_ + 1) / static_cast<float>(crossfade_hops_ + 1);
+        model_controls_.amplitude = lerp(fading_controls_.amplitude, model_controls_.amplitude, w);
+        for (size_t i = 0; i < model_controls_.harmonics.size(); ++i) {
+            model_controls_.harmonics[i] = lerp(fading_controls_.harmonics[i], model_controls_.harmonics[i], w);
+        }
+        for (size_t i = 0; i < model_controls_.noiseAmps.size(); ++i) {
+            model_controls_.noiseAmps[i] = lerp(fading_controls_.noiseAmps[i], model_controls_.noiseAmps[i], w);
+        }
+    }
+
+    if (++crossfade_position_ >= crossfade_hops_) {
+        retireModel(std::move(fading_model_));
+        crossfade_hops_ = 0;
+    }
+    return true;
+}
+
+bool InferencePipeline::isSupportedShape(const ModelSignature& signature) {
+    if (signature.num_harmonics < 1 || !NoiseSynthesizer::isSupportedBandCount(signature.num_noise_amps) ||
+        !SynthesisControlFrame::fits(signature.num_harmonics, signature.num_noise_amps)) {
+        std::cerr << "Unsupported model shape: " << signature.num_harmonics << " harmonics, "
+                  << signature.num_noise_amps << " noise bands" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<InferencePipeline::ShapeState> InferencePipeline::buildShapeState(const IControlModel& model) {
+    const ModelSignature& signature = model.getSignature();
+    auto shape = std::make_unique<ShapeState>();
+    for (SynthesisControls* controls : {&shape->model_controls, &shape->synthesis_input,
+                                        &shape->ramp_start_controls, &shape->fading_controls,
+                                        &shape->queued_controls}) {
+        controls->resize(signature.num_harmonics, signature.num_noise_amps);
+    }
+    shape->steady_state.prepare(model);
+    shape->harmonic_synth = std::make_unique<HarmonicSynthesizer>(
+        signature.num_harmonics, kModelHopSize, kModelSampleRate_Hz);
+    shape->noise_synth = std::make_unique<NoiseSynthesizer>(signature.num_noise_amps, kModelHopSize);
+    shape->harmonic_synth->getState(shape->note_on_harmonic_state);
+    return shape;
+}
+
+bool InferencePipeline::configureForModel(const IControlModel& model) {
+    if (!isSupportedShape(model.getSignature())) {
+        return false;
+    }
+    const ModelSignature& signature = model.getSignature();
+
+    if (harmonic_synth_->getNumHarmonics() != signature.num_harmonics) {
+        harmonic_synth_ = std::make_unique<HarmonicSynthesizer>(
+            signature.num_harmonics, kModelHopSize, kModelSampleRate_Hz);
+        harmonic_synth_->getState(note_on_harmonic_state_);
+    }
+    if (noise_synth_->getNumNoiseAmps() != signature.num_noise_amps) {
+        noise_synth_ = std::make_unique<NoiseSynthesizer>(signature.num_noise_amps, kModelHopSize);
+    }
+
+    for (SynthesisControls* controls : {&model_controls_, &synthesis_input_, &ramp_start_controls_,
+                                        &fading_controls_, &queued_controls_}) {
+        controls->resize(signature.num_harmonics, signature.num_noise_amps);
+    }
+    return true;
+}
+
+std::unique_ptr<WarmStateCache> InferencePipeline::buildWarmStateCache(
+    IControlModel& model, bool enabled, const WarmStateCache::Config& config) {
+    if (!enabled) {
+        return nullptr;
+    }
+    auto cache = std::make_unique<WarmStateCache>();
+    if (!cache->build(model, config)) {
+        return nullptr;
+    }
+    return cache;
+}
+
+void InferencePipeline::enableWarmStateCache(const WarmStateCache::Config& config) {
+    warm_cache_enabled_ = true;
+    warm_cache_config_ = config;
+}
+
+void InferencePipeline::disableWarmStateCache() {
+    warm_cache_enabled_ = false;
+}
+
+void InferencePipeline::enableSteadyStateSkipping(const SteadyStateDetector::Config& config) {
+    steady_state_.setConfig(config);
+    steady_state_.invalidate();
+    steady_state_enabled_.store(true, std::memory_order_relaxed);
+}
+
+void InferencePipeline::disableSteadyStateSkipping() {
+    steady_state_enabled_.store(false, std::memory_order_relaxed);
+}
+
+SteadyStateDetector::Stats InferencePipeline::getSteadyStateStats() const {
+    auto stats = steady_state_.getStats();
+    if (model_) {
+        stats.saved_ms = static_cast<double>(stats.skipped_hops) * model_->getTiming().mean_us / 1000.0;
+    }
+    return stats;
+}
+
+void InferencePipeline::resetSteadyStateStats() {
+    steady_state_.resetStats();
+}
+
+void InferencePipeline::setInferenceInterval(int hops) {
+    inference_interval_.store(std::clamp(hops, 1, 16), std::memory_order_relaxed);
+}
+
+double InferencePipeline::getEffectiveInferenceRateHz() const {
+    const uint64_t hops = rendered_hops_.load(std::memory_order_relaxed);
+    if (hops == 0) {
+        return 0.0;
+    }
+    const double hop_rate_hz = kModelSampleRate_Hz / static_cast<double>(kModelHopSize);
+    return hop_rate_hz * static_cast<double>(model_invocations_.load(std::memory_order_relaxed)) /
+           static_cast<double>(hops);
+}
+
+void InferencePipeline::noteOn(float f0_hz, float loudness_norm) {
+    setControls(f0_hz, loudness_norm);
+    note_on_pending_.store(true, std::memory_order_release);
+}
+
+void InferencePipeline::applyNoteOn(float f0_hz, float loudness_norm) {
+    if (warm_cache_) {
+        if (const float* state = warm_cache_->lookup(f0_hz, loudness_norm)) {
+            model_->setState(state, warm_cache_->stateSize());
+        }
+    }
+
+    steady_state_.invalidate();
+    hops_until_inference_ = 0;
+    snap_controls_ = true;
+}
+
+bool InferencePipeline::captureVoiceState(VoiceState& state) const {
+    if (!model_) {
+        return false;
+    }
+    state.model_state.resize(model_->stateSize());
+    if (!model_->getState(state.model_state.data(), state.model_state.size())) {
+        return false;
+    }
+    harmonic_synth_->getState(state.harmonic);
+    return true;
+}
+
+bool InferencePipeline::restoreVoiceState(const VoiceState& state) {
+    if (!model_ || !model_->setState(state.model_state.data(), state.model_state.size())) {
+        return false;
+    }
+    harmonic_synth_->setState(state.harmonic);
+    steady_state_.invalidate();
+    return true;
+}
+
+ControlModelBackend InferencePipeline::getBackend() const {
+    return model_ ? model_->backend() : ControlModelBackend::Default;
+}
+
+InferenceTiming InferencePipeline::getInferenceTiming() const {
+    return model_ ? model_->getTiming() : InferenceTiming{};
+}
+
+StartupProfile InferencePipeline::getStartupProfile() const {
+    return model_ ? model_->getStartupProfile() : StartupProfile{};
+}
+
 void InferencePipeline::startTimer(int interval_ms) {
-    if (should_run_.load()) {
-        return;  // Already running
+    if (should_run_.load() || pull_mode_.load(std::memory_order_relaxed)) {
+        return;  // Already running, or getNextBlock() renders
     }
 
     should_run_.store(true);
+    resetRenderSchedulerStats();
+
+    // Shared workers: no threads of our own
+    if (render_pool_) {
+        active_pool_ = render_pool_;
+        active_pool_->add(*this, interval_ms);
+        return;
+    }
+
+    // Inference stage runs ahead of the render thread in pipelined mode
+    if (pipelined_.load(std::memory_order_relaxed)) {
+        inference_thread_ = std::make_unique<std::thread>([this, interval_ms]() {
+            inferenceLoop(interval_ms);
+        });
+    }
 
     // Start background rendering thread
     render_thread_ = std::make_unique<std::thread>([this, interval_ms]() {
@@ -89,47 +691,263 @@ void InferencePipeline::startTimer(int interval_ms) {
 void InferencePipeline::stopTimer() {
     should_run_.store(false);
 
+    if (active_pool_) {
+        active_pool_->remove(*this);
+        active_pool_ = nullptr;
+    }
+
+    // Wake both stages so neither waits out its timeout
+    controls_ready_.signal();
+    controls_consumed_.signal();
+
     if (render_thread_ && render_thread_->joinable()) {
         render_thread_->join();
     }
     render_thread_.reset();
+
+    if (inference_thread_ && inference_thread_->joinable()) {
+        inference_thread_->join();
+    }
+    inference_thread_.reset();
+}
+
+void InferencePipeline::setTargetFillSamples(int samples) {
+    target_fill_samples_.store(std::clamp(samples, 0, kRingBufferSize - 1), std::memory_order_relaxed);
+}
+
+int InferencePipeline::getTargetFillSamples() const {
+    const int target = target_fill_samples_.load(std::memory_order_relaxed);
+    const int fill = target > 0 ? target : watermarkForMode(latency_mode_.load(std::memory_order_relaxed));
+
+    // Leave room for the hop that crosses the watermark
+    const int max_fill = output_capacity_ > 0 ? output_capacity_ - 1 - user_hop_size_ : kRingBufferSize - 1;
+    return std::max(std::min(fill, max_fill), 0);
+}
+
+int InferencePipeline::watermarkForMode(LatencyMode mode) const {
+    int hops_ahead = 1;
+    switch (mode) {
+        case LatencyMode::Minimum: hops_ahead = 0; break;
+        case LatencyMode::Balanced: hops_ahead = 1; break;
+        case LatencyMode::Safe: hops_ahead = 2; break;
+    }
+    // Never below one hop, or a small host block could starve the FIFO
+    return std::max(samples_per_block_ + hops_ahead * user_hop_size_, user_hop_size_);
+}
+
+void InferencePipeline::setLatencyMode(LatencyMode mode) {
+    latency_mode_.store(mode, std::memory_order_relaxed);
+}
+
+int InferencePipeline::getLatencySamples() const {
+    double latency = getNumReadySamples();
+
+    // Controls inferred but not yet synthesized (empty unless pipelined)
+    latency += static_cast<double>(control_fifo_.getNumReady()) * user_hop_size_;
+
+    // Reduced-rate inference ramps towards new controls over the interval
+    latency += static_cast<double>(inference_interval_.load(std::memory_order_relaxed) - 1) * user_hop_size_;
+
+    // Resampler delay is in model-rate samples
+    const double resampler_latency = output_resampler_.isPrepared()
+        ? output_resampler_.getLatencyInputSamples()
+        : static_cast<double>(juce::WindowedSincInterpolator::getBaseLatency());
+    latency += resampler_latency * sample_rate_ / kModelSampleRate_Hz;
+
+    return static_cast<int>(std::lround(latency));
+}
+
+InferencePipeline::RenderSchedulerStats InferencePipeline::getRenderSchedulerStats() const {
+    RenderSchedulerStats stats;
+    stats.wakeups = scheduler_wakeups_.load(std::memory_order_relaxed);
+    stats.hops = scheduler_hops_.load(std::memory_order_relaxed);
+    stats.catch_up_hops = scheduler_catch_up_hops_.load(std::memory_order_relaxed);
+    stats.idle_wakeups = scheduler_idle_wakeups_.load(std::memory_order_relaxed);
+    stats.underruns = scheduler_underruns_.load(std::memory_order_relaxed);
+    stats.fill_samples = scheduler_fill_samples_.load(std::memory_order_relaxed);
+
+    // Wake-ups need not be one hop apart, so drift is measured in samples
+    // against the clock rather than in hops against wake-ups
+    const int64_t start_ns = scheduler_start_ns_.load(std::memory_order_relaxed);
+    const double elapsed_ms = start_ns > 0 ? static_cast<double>(steadyNowNs() - start_ns) / 1.0e6 : 0.0;
+    if (sample_rate_ > 0.0 && elapsed_ms > 0.0) {
+        const double rendered = static_cast<double>(stats.hops) * user_hop_size_;
+        const double buffered = stats.fill_samples - scheduler_start_fill_.load(std::memory_order_relaxed);
+        stats.corrected_drift_ms = 1000.0 * (rendered - buffered) / sample_rate_ - elapsed_ms;
+        stats.drift_ppm = stats.corrected_drift_ms / elapsed_ms * 1.0e6;
+    }
+    return stats;
+}
+
+void InferencePipeline::resetRenderSchedulerStats() {
+    scheduler_wakeups_.store(0, std::memory_order_relaxed);
+    scheduler_hops_.store(0, std::memory_order_relaxed);
+    scheduler_catch_up_hops_.store(0, std::memory_order_relaxed);
+    scheduler_idle_wakeups_.store(0, std::memory_order_relaxed);
+    scheduler_underruns_.store(0, std::memory_order_relaxed);
+    const int fill = getNumReadySamples();
+    scheduler_fill_samples_.store(fill, std::memory_order_relaxed);
+    scheduler_start_fill_.store(fill, std::memory_order_relaxed);
+    scheduler_start_ns_.store(steadyNowNs(), std::memory_order_relaxed);
+}
+
+void InferencePipeline::setRenderPool(RenderPool* pool) {
+    render_pool_ = pool;
+}
+
+void InferencePipeline::setPullRendering(bool enabled) {
+    if (enabled) {
+        stopTimer();
+    }
+    pull_mode_.store(enabled, std::memory_order_relaxed);
+}
+
+void InferencePipeline::setPipelinedRendering(bool enabled) {
+    // Frames queued by a previous pipelined run are dropped either way
+    control_fifo_.reset();
+    pipelined_.store(enabled, std::memory_order_relaxed);
 }
 
 void InferencePipeline::processBlock(juce::AudioBuffer<float>& buffer, int num_samples) {
     // In synth mode, we don't use input audio
-    // Just trigger processing by updating the input buffer
-
-    // For synth mode with no audio input, we don't need to push anything
-    // The render() function uses the atomic parameters directly
+    // The render() function uses the control parameters directly
+    if (input_fifo_) {
+        pushToInputBuffer(buffer, num_samples);
+    }
 }
 
 int InferencePipeline::getNextBlock(float* output, int num_samples) {
+    RealtimeChecker::Scope realtime;
+
+    if (pull_mode_.load(std::memory_order_relaxed)) {
+        // Render just enough hops; stop if a hop adds nothing (no model, FIFO full)
+        int level = getNumReadySamples();
+        while (level < num_samples) {
+            render();
+            const int new_level = getNumReadySamples();
+            if (new_level <= level) {
+                break;
+            }
+            level = new_level;
+        }
+    }
     return popFromOutputBuffer(output, num_samples);
 }
 
 void InferencePipeline::setF0Hz(float f0_hz) {
-    f0_hz_.store(std::clamp(f0_hz, kPitchRangeMin_Hz, kPitchRangeMax_Hz));
+    controls_.update([f0_hz](ControlValues& values) {
+        values.f0_hz = std::clamp(f0_hz, kPitchRangeMin_Hz, kPitchRangeMax_Hz);
+        values.f0_revision++;
+    });
 }
 
 void InferencePipeline::setLoudnessNorm(float loudness_norm) {
-    loudness_norm_.store(std::clamp(loudness_norm, 0.0f, 1.0f));
+    controls_.update([loudness_norm](ControlValues& values) {
+        values.loudness_norm = std::clamp(loudness_norm, 0.0f, 1.0f);
+        values.loudness_revision++;
+    });
 }
 
 void InferencePipeline::setLoudnessDb(float loudness_db) {
-    float norm = normalizedLoudness(loudness_db);
-    loudness_norm_.store(std::clamp(norm, 0.0f, 1.0f));
+    setLoudnessNorm(normalizedLoudness(loudness_db));
+}
+
+void InferencePipeline::setControls(float f0_hz, float loudness_norm) {
+    controls_.update([f0_hz, loudness_norm](ControlValues& values) {
+        values.f0_hz = std::clamp(f0_hz, kPitchRangeMin_Hz, kPitchRangeMax_Hz);
+        values.loudness_norm = std::clamp(loudness_norm, 0.0f, 1.0f);
+        values.f0_revision++;
+        values.loudness_revision++;
+    });
 }
 
 void InferencePipeline::setPitchShift(float semitones) {
-    pitch_shift_semitones_.store(semitones);
+    controls_.update([semitones](ControlValues& values) { values.pitch_shift_semitones = semitones; });
 }
 
 void InferencePipeline::setHarmonicGain(float gain) {
-    harmonic_gain_.store(std::clamp(gain, 0.0f, 10.0f));
+    controls_.update([gain](ControlValues& values) { values.harmonic_gain = std::clamp(gain, 0.0f, 10.0f); });
 }
 
 void InferencePipeline::setNoiseGain(float gain) {
-    noise_gain_.store(std::clamp(gain, 0.0f, 10.0f));
+    controls_.update([gain](ControlValues& values) { values.noise_gain = std::clamp(gain, 0.0f, 10.0f); });
+}
+
+bool InferencePipeline::pushControlEvent(const ControlEvent& event) {
+    int start1, size1, start2, size2;
+    event_fifo_.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 + size2 == 0) {
+        return false;
+    }
+    events_[static_cast<size_t>(size1 > 0 ? start1 : start2)] = event;
+    event_fifo_.finishedWrite(1);
+    return true;
+}
+
+bool InferencePipeline::applyControlEvents(float& f0_hz, float& loudness_norm, bool& note_on,
+                                           const ControlValues& values) {
+    const int64_t hop_start = infer_position_;
+    const int64_t hop_end = hop_start + user_hop_size_;
+
+    // Integrate the piecewise-constant controls over the hop
+    double f0_sum = 0.0;
+    double loudness_sum = 0.0;
+    int64_t cursor = hop_start;
+    bool applied = false;
+
+    for (;;) {
+        int start1, size1, start2, size2;
+        event_fifo_.prepareToRead(1, start1, size1, start2, size2);
+        if (size1 + size2 == 0) {
+            break;
+        }
+        const ControlEvent& event = events_[static_cast<size_t>(size1 > 0 ? start1 : start2)];
+        if (event.sample_time >= hop_end) {
+            break;  // Belongs to a later hop
+        }
+
+        if (event.flags & ControlEvent::kNoteOn) {
+            // The new note owns the hop from its start
+            f0_sum = 0.0;
+            loudness_sum = 0.0;
+            cursor = hop_start;
+            note_on = true;
+        } else if (event.sample_time > cursor) {
+            const double span = static_cast<double>(event.sample_time - cursor);
+            f0_sum += f0_hz * span;
+            loudness_sum += loudness_norm * span;
+            cursor = event.sample_time;
+        }
+
+        if (event.flags & (ControlEvent::kF0 | ControlEvent::kNoteOn)) {
+            f0_hz = std::clamp(event.f0_hz, kPitchRangeMin_Hz, kPitchRangeMax_Hz);
+        }
+        if (event.flags & (ControlEvent::kLoudness | ControlEvent::kNoteOn)) {
+            loudness_norm = std::clamp(event.loudness_norm, 0.0f, 1.0f);
+        }
+
+        event_fifo_.finishedRead(1);
+        applied = true;
+    }
+
+    if (!applied) {
+        return false;
+    }
+
+    // Later hops continue from the last event's values until the next parameter write
+    event_f0_hz_ = f0_hz;
+    event_loudness_norm_ = loudness_norm;
+    event_f0_revision_ = values.f0_revision;
+    event_loudness_revision_ = values.loudness_revision;
+    event_values_valid_ = true;
+
+    const double span = static_cast<double>(hop_end - cursor);
+    const double total = static_cast<double>(hop_end - hop_start);
+    if (total > 0.0) {
+        f0_hz = static_cast<float>((f0_sum + f0_hz * span) / total);
+        loudness_norm = static_cast<float>((loudness_sum + loudness_norm * span) / total);
+    }
+    return true;
 }
 
 void InferencePipeline::reset() {
@@ -137,6 +955,15 @@ void InferencePipeline::reset() {
     if (model_) {
         model_->reset();
     }
+    if (fading_model_) {
+        fading_model_->reset();
+    }
+    steady_state_.invalidate();
+    model_controls_.clear();
+    hops_until_inference_ = 0;
+    snap_controls_ = true;
+    rendered_hops_.store(0, std::memory_order_relaxed);
+    model_invocations_.store(0, std::memory_order_relaxed);
 
     // Reset synthesizers
     if (harmonic_synth_) {
@@ -161,13 +988,42 @@ void InferencePipeline::reset() {
     }
     input_ring_buffer_.clear();
     output_ring_buffer_.clear();
+    control_fifo_.reset();
+
+    // Restart the event timeline; pending events are dropped
+    event_fifo_.reset();
+    event_values_valid_ = false;
+    infer_position_ = 0;
+    host_position_.store(0, std::memory_order_release);
 
     // Reset interpolators
     input_interpolator_.reset();
     output_interpolator_.reset();
+    output_resampler_.reset();
+
+    // Synth mode never reads the input FIFO, so only Safe keeps the legacy
+    // zero frame; Safe also starts with a hop of silence against underruns
+    if (latency_mode_.load(std::memory_order_relaxed) == LatencyMode::Safe) {
+        zeroPadInputBuffer();
+        prefillOutputBuffer(user_hop_size_);
+        infer_position_ = user_hop_size_;  // The silent hop comes first on the timeline
+    }
+}
 
-    // Zero-pad input buffer for latency compensation
-    zeroPadInputBuffer();
+void InferencePipeline::prefillOutputBuffer(int num_samples) {
+    if (num_samples <= 0 || !output_fifo_) {
+        return;
+    }
+
+    float* dst = output_ring_buffer_.getWritePointer(0);
+
+    int start1, size1, start2, size2;
+    output_fifo_->prepareToWrite(num_samples, start1, size1, start2, size2);
+
+    std::fill(dst + start1, dst + start1 + size1, 0.0f);
+    std::fill(dst + start2, dst + start2 + size2, 0.0f);
+
+    output_fifo_->finishedWrite(size1 + size2);
 }
 
 void InferencePipeline::zeroPadInputBuffer() {
@@ -175,16 +1031,22 @@ void InferencePipeline::zeroPadInputBuffer() {
         return;
     }
 
-    // Push zeros to input buffer
-    juce::AudioBuffer<float> zero_buffer(1, user_frame_size_);
-    zero_buffer.clear();
-    pushToInputBuffer(zero_buffer);
+    // Zero the ring buffer in place rather than pushing a temporary buffer
+    float* dst = input_ring_buffer_.getWritePointer(0);
+
+    int start1, size1, start2, size2;
+    input_fifo_->prepareToWrite(user_frame_size_, start1, size1, start2, size2);
+
+    std::fill(dst + start1, dst + start1 + size1, 0.0f);
+    std::fill(dst + start2, dst + start2 + size2, 0.0f);
+
+    input_fifo_->finishedWrite(size1 + size2);
 }
 
-void InferencePipeline::pushToInputBuffer(const juce::AudioBuffer<float>& buffer) {
+void InferencePipeline::pushToInputBuffer(const juce::AudioBuffer<float>& buffer, int num_samples) {
     if (!input_fifo_) return;
 
-    int num_samples = buffer.getNumSamples();
+    num_samples = std::min(num_samples, buffer.getNumSamples());
     const float* src = buffer.getReadPointer(0);
     float* dst = input_ring_buffer_.getWritePointer(0);
 
@@ -219,6 +1081,7 @@ int InferencePipeline::popFromOutputBuffer(float* output, int num_samples) {
     }
 
     output_fifo_->finishedRead(total_read);
+    host_position_.fetch_add(total_read, std::memory_order_acq_rel);
 
     // Fill remaining with silence
     if (total_read < num_samples) {
@@ -229,35 +1092,166 @@ int InferencePipeline::popFromOutputBuffer(float* output, int num_samples) {
 }
 
 void InferencePipeline::renderLoop(int interval_ms) {
+    const auto period = std::chrono::milliseconds(std::max(interval_ms, 1));
+    auto deadline = std::chrono::steady_clock::now();
+
     while (should_run_.load()) {
-        auto start = std::chrono::steady_clock::now();
+        renderToWatermark(interval_ms);
+
+        // Absolute deadlines; after a stall, restart from now rather than
+        // firing a burst of late wake-ups
+        deadline += period;
+        const auto now = std::chrono::steady_clock::now();
+        if (deadline < now) {
+            deadline = now;
+        }
+        sleepUntil(deadline);
+    }
+}
 
-        // Run one render iteration
-        render();
+int InferencePipeline::renderToWatermark(int interval_ms) {
+    const int target = getTargetFillSamples();
+    int level = getNumReadySamples();
+
+    if (level == 0) {
+        scheduler_underruns_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Render ahead until the host has a block plus a hop in hand;
+    // stop early if a hop produced nothing (no model yet)
+    int hops = 0;
+    while (level < target && hops < kMaxHopsPerWakeup && should_run_.load()) {
+        renderHop(interval_ms);
+        const int new_level = getNumReadySamples();
+        if (new_level <= level) {
+            break;
+        }
+        level = new_level;
+        ++hops;
+    }
+
+    scheduler_wakeups_.fetch_add(1, std::memory_order_relaxed);
+    scheduler_hops_.fetch_add(static_cast<uint64_t>(hops), std::memory_order_relaxed);
+    if (hops == 0) {
+        scheduler_idle_wakeups_.fetch_add(1, std::memory_order_relaxed);
+    } else if (hops > 1) {
+        scheduler_catch_up_hops_.fetch_add(static_cast<uint64_t>(hops - 1), std::memory_order_relaxed);
+    }
+    scheduler_fill_samples_.store(level, std::memory_order_relaxed);
 
-        // Sleep for remaining time
-        auto end = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-        auto sleep_time = std::chrono::milliseconds(interval_ms) - elapsed;
+    // Models swapped out during those hops are freed here, off the hop
+    freeRetiredModels();
+    return hops;
+}
 
-        if (sleep_time.count() > 0) {
-            std::this_thread::sleep_for(sleep_time);
+void InferencePipeline::renderHop(int timeout_ms) {
+    // Pooled pipelines have no inference thread and render serially
+    if (inference_thread_) {
+        renderQueuedHop(timeout_ms);
+    } else {
+        render();
+    }
+}
+
+void InferencePipeline::inferenceLoop(int interval_ms) {
+    while (should_run_.load()) {
+        // Queue full, no model or failed inference: wait for the render thread
+        if (control_fifo_.getFreeSpace() == 0 || !pushControlFrame()) {
+            controls_consumed_.wait(interval_ms);
         }
     }
 }
 
+bool InferencePipeline::pushControlFrame() {
+    RealtimeChecker::Scope realtime;
+
+    bool note_on = false;
+    if (!inferHop(note_on)) {
+        return false;
+    }
+
+    int start1, size1, start2, size2;
+    control_fifo_.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 + size2 == 0) {
+        return false;
+    }
+
+    SynthesisControlFrame& frame = control_frames_[static_cast<size_t>(size1 > 0 ? start1 : start2)];
+    frame.assign(synthesis_input_);  // Always fits: configureForModel() checked the shape
+    frame.flags = note_on ? SynthesisControlFrame::kNoteOn : 0u;
+    frame.sequence = rendered_hops_.load(std::memory_order_relaxed);
+
+    control_fifo_.finishedWrite(1);
+
+    // Lock-free wake-up of the synthesis stage
+    controls_ready_.signal();
+    return true;
+}
+
+void InferencePipeline::renderQueuedHop(int timeout_ms) {
+    // Waiting blocks by design, so it stays outside the realtime scope
+    if (control_fifo_.getNumReady() == 0) {
+        controls_ready_.wait(timeout_ms);
+    }
+
+    RealtimeChecker::Scope realtime;
+
+    int start1, size1, start2, size2;
+    control_fifo_.prepareToRead(1, start1, size1, start2, size2);
+    if (size1 + size2 == 0) {
+        return;  // Inference stage has nothing yet (no model, or underrun)
+    }
+
+    // Release the slot before synthesizing so the next hop can be inferred meanwhile
+    const SynthesisControlFrame& frame = control_frames_[static_cast<size_t>(size1 > 0 ? start1 : start2)];
+    if (frame.num_harmonics != harmonic_synth_->getNumHarmonics() ||
+        frame.num_noise_amps != noise_synth_->getNumNoiseAmps()) {
+        adoptStagedShape();  // First hop from a model of another shape
+    }
+    frame.copyTo(queued_controls_);
+    const bool note_on = (frame.flags & SynthesisControlFrame::kNoteOn) != 0;
+    control_fifo_.finishedRead(1);
+
+    controls_consumed_.signal();
+    synthesizeHop(queued_controls_, note_on);
+}
+
 void InferencePipeline::render() {
-    if (!model_ready_) {
-        return;
+    RealtimeChecker::Scope realtime;
+
+    bool note_on = false;
+    if (inferHop(note_on)) {
+        adoptStagedShape();  // Both stages run here, so a new shape applies at once
+        synthesizeHop(synthesis_input_, note_on);
+    }
+}
+
+bool InferencePipeline::inferHop(bool& note_on) {
+    // Hop boundary: pick up a model prepared by loadModelAsync
+    swapPendingModel();
+
+    if (!model_ready_.load(std::memory_order_acquire)) {
+        return false;
     }
 
-    // --- SYNTH MODE: Get F0/loudness from parameters ---
-    float f0_hz = f0_hz_.load();
-    float loudness_norm = loudness_norm_.load();
-    float pitch_shift = pitch_shift_semitones_.load();
+    // Read before the parameters so a note-on sees its own f0/loudness
+    note_on = note_on_pending_.exchange(false, std::memory_order_acquire);
+
+    // --- SYNTH MODE: Get F0/loudness from parameters and due events ---
+    const ControlValues values = controls_.load();
+    float f0_hz = values.f0_hz;
+    float loudness_norm = values.loudness_norm;
+    if (event_values_valid_ && event_f0_revision_ == values.f0_revision) {
+        f0_hz = event_f0_hz_;
+    }
+    if (event_values_valid_ && event_loudness_revision_ == values.loudness_revision) {
+        loudness_norm = event_loudness_norm_;
+    }
+    applyControlEvents(f0_hz, loudness_norm, note_on, values);
+    infer_position_ += user_hop_size_;
 
     // Apply pitch shift
-    f0_hz = offsetPitch(f0_hz, pitch_shift);
+    f0_hz = offsetPitch(f0_hz, values.pitch_shift_semitones);
 
     // Calculate normalized F0
     float f0_norm = normalizedPitch(f0_hz);
@@ -272,29 +1266,43 @@ void InferencePipeline::render() {
     predict_controls_input_.loudness_norm = loudness_norm;
     predict_controls_input_.loudness_db = denormalizeLoudness(loudness_norm);
 
-    // --- RUN MODEL INFERENCE ---
-    if (!model_->call(predict_controls_input_, synthesis_input_)) {
-        std::cerr << "Inference failed" << std::endl;
-        return;
+    if (note_on) {
+        applyNoteOn(f0_hz, loudness_norm);
     }
 
-    // --- APPLY OUTPUT GAINS ---
-    float harm_gain = harmonic_gain_.load();
-    float noise_gain = noise_gain_.load();
+    // --- RUN MODEL INFERENCE (every Nth hop; interpolated in between) ---
+    // Counted, not logged: stream output can allocate and lock
+    if (!updateControls()) {
+        inference_failures_.fetch_add(1, std::memory_order_relaxed);
+        last_inference_error_.store(model_ ? model_->getLastError() : InferenceError::NotReady,
+                                    std::memory_order_relaxed);
+        return false;
+    }
 
-    synthesis_input_.amplitude *= harm_gain;
+    // --- APPLY OUTPUT GAINS ---
+    synthesis_input_.amplitude *= values.harmonic_gain;
     for (auto& amp : synthesis_input_.noiseAmps) {
-        amp *= noise_gain;
+        amp *= values.noise_gain;
+    }
+    return true;
+}
+
+void InferencePipeline::synthesizeHop(SynthesisControls& controls, bool note_on) {
+    if (note_on) {
+        // Keep the phase, but start the new note at its own pitch
+        harmonic_synth_->getState(note_on_harmonic_state_);
+        note_on_harmonic_state_.f0 = controls.f0_hz;
+        harmonic_synth_->setState(note_on_harmonic_state_);
     }
 
     // --- SYNTHESIZE AUDIO ---
     const auto& harmonic_output = harmonic_synth_->render(
-        synthesis_input_.harmonics,
-        synthesis_input_.amplitude,
-        synthesis_input_.f0_hz
+        controls.harmonics,
+        controls.amplitude,
+        controls.f0_hz
     );
 
-    const auto& noise_output = noise_synth_->render(synthesis_input_.noiseAmps);
+    const auto& noise_output = noise_synth_->render(controls.noiseAmps);
 
     // --- MIX HARMONIC + NOISE ---
     float* synthesis_ptr = synthesis_buffer_.getWritePointer(0);
@@ -304,12 +1312,16 @@ void InferencePipeline::render() {
 
     // --- UPSAMPLE TO USER SAMPLE RATE ---
     float* output_ptr = resampled_model_output_buffer_.getWritePointer(0);
-    output_interpolator_.process(
-        kModelSampleRate_Hz / sample_rate_,  // Inverse ratio for upsampling
-        synthesis_ptr,
-        output_ptr,
-        resampled_model_output_buffer_.getNumSamples()
-    );
+    if (output_resampler_.isPrepared()) {
+        output_resampler_.process(synthesis_ptr, kModelHopSize, output_ptr);
+    } else {
+        output_interpolator_.process(
+            kModelSampleRate_Hz / sample_rate_,  // Inverse ratio for upsampling
+            synthesis_ptr,
+            output_ptr,
+            resampled_model_output_buffer_.getNumSamples()
+        );
+    }
 
     // --- PUSH TO OUTPUT RING BUFFER ---
     if (output_fifo_) {
@@ -329,11 +1341,36 @@ void InferencePipeline::render() {
     }
 }
 
+InferencePipeline::MemoryUsage InferencePipeline::memoryUsage() const {
+    MemoryUsage usage;
+    usage.object = sizeof(InferencePipeline);
+    usage.output_fifo = bufferBytes(output_ring_buffer_);
+    usage.input_path = bufferBytes(input_ring_buffer_) + bufferBytes(model_input_buffer_) +
+                       bufferBytes(resampled_model_input_buffer_);
+    usage.working_buffers = bufferBytes(synthesis_buffer_) + bufferBytes(resampled_model_output_buffer_);
+
+    usage.controls = controlsBytes(model_controls_) + controlsBytes(synthesis_input_) +
+                     controlsBytes(ramp_start_controls_) + controlsBytes(fading_controls_) +
+                     controlsBytes(queued_controls_) +
+                     note_on_harmonic_state_.harmonic_distribution.capacity() * sizeof(float);
+
+    usage.resampler = output_resampler_.getMemoryBytes();
+    usage.shared_resampler_table = output_resampler_.getTableBytes();
+    usage.harmonic_synth = harmonic_synth_ ? harmonic_synth_->getMemoryBytes() : 0;
+    usage.noise_synth = noise_synth_ ? noise_synth_->getMemoryBytes() : 0;
+    usage.model_state = model_ ? model_->stateSize() * sizeof(float) : 0;
+    usage.warm_cache = warm_cache_ ? warm_cache_->memoryBytes() : 0;
+    return usage;
+}
+
 int InferencePipeline::getNumReadySamples() const {
     return output_fifo_ ? output_fifo_->getNumReady() : 0;
 }
 
 void InferencePipeline::triggerRender() {
+    if (should_run_.load() || pull_mode_.load(std::memory_order_relaxed)) {
+        return;  // The timer thread or getNextBlock() owns the render state
+    }
     render();
 }
 
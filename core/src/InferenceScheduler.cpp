@@ -0,0 +1,126 @@
+#include "InferenceScheduler.h"
+#include <algorithm>
+#include <thread>
+
+namespace ddsp {
+
+InferenceScheduler::ThreadLease::ThreadLease(ThreadLease&& other) noexcept
+    : scheduler_(other.scheduler_)
+    , worker_threads_(other.worker_threads_)
+{
+    other.scheduler_ = nullptr;
+    other.worker_threads_ = 0;
+}
+
+InferenceScheduler::ThreadLease& InferenceScheduler::ThreadLease::operator=(ThreadLease&& other) noexcept {
+    if (this != &other) {
+        release();
+        scheduler_ = other.scheduler_;
+        worker_threads_ = other.worker_threads_;
+        other.scheduler_ = nullptr;
+        other.worker_threads_ = 0;
+    }
+    return *this;
+}
+
+void InferenceScheduler::ThreadLease::release() {
+    if (scheduler_) {
+        scheduler_->release(worker_threads_);
+        scheduler_ = nullptr;
+    }
+    worker_threads_ = 0;
+}
+
+InferenceScheduler& InferenceScheduler::instance() {
+    static InferenceScheduler scheduler;
+    return scheduler;
+}
+
+InferenceScheduler::InferenceScheduler()
+    : thread_budget_(std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2))
+    , threads_in_use_(0)
+    , active_leases_(0)
+    , clamped_leases_(0)
+    , policy_(ParallelismPolicy::Requested)
+    , max_threads_per_invocation_(2)
+{
+}
+
+InferenceScheduler::ThreadLease InferenceScheduler::acquire(int requested_threads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int wanted = std::max(requested_threads, 1);
+    switch (policy_) {
+        case ParallelismPolicy::SingleThreaded:
+            wanted = 1;
+            break;
+        case ParallelismPolicy::Capped:
+            wanted = std::min(wanted, max_threads_per_invocation_);
+            break;
+        case ParallelismPolicy::Requested:
+            break;
+    }
+
+    const int available = std::max(thread_budget_ - threads_in_use_, 0);
+    const int workers = std::min(wanted - 1, available);
+    if (workers + 1 < std::max(requested_threads, 1)) {
+        clamped_leases_++;
+    }
+
+    threads_in_use_ += workers;
+    active_leases_++;
+
+    ThreadLease lease;
+    lease.scheduler_ = this;
+    lease.worker_threads_ = workers;
+    return lease;
+}
+
+void InferenceScheduler::release(int worker_threads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_in_use_ -= worker_threads;
+    active_leases_--;
+}
+
+void InferenceScheduler::setThreadBudget(int worker_threads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    thread_budget_ = std::max(worker_threads, 0);
+}
+
+int InferenceScheduler::getThreadBudget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return thread_budget_;
+}
+
+void InferenceScheduler::setParallelismPolicy(ParallelismPolicy policy, int max_threads_per_invocation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_ = policy;
+    max_threads_per_invocation_ = std::max(max_threads_per_invocation, 1);
+}
+
+ParallelismPolicy InferenceScheduler::getParallelismPolicy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return policy_;
+}
+
+int InferenceScheduler::getMaxThreadsPerInvocation() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    switch (policy_) {
+        case ParallelismPolicy::SingleThreaded: return 1;
+        case ParallelismPolicy::Capped:         return max_threads_per_invocation_;
+        case ParallelismPolicy::Requested:      return 0;
+    }
+    return 0;
+}
+
+InferenceScheduler::Stats InferenceScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.thread_budget = thread_budget_;
+    stats.threads_in_use = threads_in_use_;
+    stats.active_leases = active_leases_;
+    stats.clamped_leases = clamped_leases_;
+    return stats;
+}
+
+} // namespace ddsp
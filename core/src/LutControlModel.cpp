@@ -0,0 +1,111 @@
+#include "LutControlModel.h"
+#include "Hash.h"
+#include "ModelBlob.h"
+#include <chrono>
+#include <iostream>
+
+namespace ddsp {
+
+namespace {
+
+bool hasSuffix(const std::string& value, const std::string& suffix) {
+    return value.size() >= suffix.size() &&
+           value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Content hash, so a retrained model of the same size still invalidates the table
+uint64_t fileHash(const std::string& path) {
+    auto blob = ModelBlob::mapFile(path);
+    return blob ? fnv1a(blob->data(), blob->size()) : 0;
+}
+
+} // namespace
+
+LutControlModel::LutControlModel()
+    : model_loaded_(false)
+{
+}
+
+bool LutControlModel::loadModel(const std::string& model_path, const ModelLoadOptions& options) {
+    const auto load_start = std::chrono::steady_clock::now();
+    model_loaded_ = false;
+    startup_profile_ = StartupProfile{};
+
+    auto finish = [&]() {
+        model_loaded_ = true;
+        startup_profile_.total_ms =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+        return true;
+    };
+
+    if (hasSuffix(model_path, ".lut")) {
+        if (!table_.load(model_path)) {
+            std::cerr << "Failed to load control lookup table: " << model_path << std::endl;
+            return false;
+        }
+        startup_profile_.file_read_ms =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+        return finish();
+    }
+
+    // No path (e.g. Stub backend) or an unreadable model cannot be matched
+    // to a table on disk, so it is swept and not cached
+    const std::string lut_path = options.lut_path.empty() && !model_path.empty()
+        ? model_path + ".lut"
+        : options.lut_path;
+    const uint64_t source_hash = fileHash(model_path);
+    const bool cacheable = !lut_path.empty() && source_hash != 0;
+
+    // Reuse the serialised table if it was built from this model with this grid
+    if (cacheable && table_.load(lut_path) && table_.sourceModelHash() == source_hash &&
+        table_.pitchSteps() == options.lut_pitch_steps &&
+        table_.loudnessSteps() == options.lut_loudness_steps) {
+        startup_profile_.file_read_ms =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+        return finish();
+    }
+
+    if (options.lut_source_backend == ControlModelBackend::LookupTable) {
+        std::cerr << "Lookup table source backend must run inference" << std::endl;
+        return false;
+    }
+
+    auto source = createControlModel(options.lut_source_backend);
+    if (!source) {
+        std::cerr << "Lookup table source backend not available in this build: "
+                  << controlModelBackendName(resolveControlModelBackend(options.lut_source_backend)) << std::endl;
+        return false;
+    }
+
+    ModelLoadOptions source_options = options;
+    source_options.warmup_invocations = 0;
+    if (!source->loadModel(model_path, source_options)) {
+        return false;
+    }
+
+    const auto sweep_start = std::chrono::steady_clock::now();
+    ControlLookupTable::Config config;
+    config.pitch_steps = options.lut_pitch_steps;
+    config.loudness_steps = options.lut_loudness_steps;
+    if (!table_.build(*source, config)) {
+        return false;
+    }
+    startup_profile_.warmup_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sweep_start).count();
+
+    if (cacheable && !table_.save(lut_path, source_hash)) {
+        std::cerr << "Control lookup table not cached; it will be rebuilt on next load" << std::endl;
+    }
+    return finish();
+}
+
+bool LutControlModel::invoke(const AudioFeatures& input, SynthesisControls& output) {
+    if (!model_loaded_) {
+        return false;
+    }
+    table_.lookup(input.f0_norm, input.loudness_norm, output);
+    output.f0_hz = input.f0_hz;
+    return true;
+}
+
+} // namespace ddsp
@@ -0,0 +1,177 @@
+#include "MemoizedControlModel.h"
+#include "Hash.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ddsp {
+
+namespace {
+
+// Per-entry bookkeeping in std::list/std::unordered_map (approximate)
+constexpr size_t kEntryOverheadBytes = 96;
+
+} // namespace
+
+MemoizedControlModel::MemoizedControlModel(std::unique_ptr<IControlModel> inner, size_t budget_bytes,
+                                           int quantisation_steps)
+    : inner_(std::move(inner))
+    , budget_bytes_(budget_bytes)
+    , quantisation_steps_(static_cast<float>(std::max(quantisation_steps, 2) - 1))
+    , key_(kFnvOffset)
+    , inner_stale_(false)
+    , bytes_(0)
+    , control_values_(kAmplitudeSize + kHarmonicsSize + kNoiseAmpsSize)
+{
+}
+
+bool MemoizedControlModel::loadModel(const std::string& model_path, const ModelLoadOptions& options) {
+    clearCache();
+    return finishLoad(inner_->loadModel(model_path, options));
+}
+
+bool MemoizedControlModel::loadModelFromBlob(std::shared_ptr<const ModelBlob> blob, const ModelLoadOptions& options) {
+    clearCache();
+    return finishLoad(inner_->loadModelFromBlob(std::move(blob), options));
+}
+
+bool MemoizedControlModel::finishLoad(bool loaded) {
+    startup_profile_ = inner_->getStartupProfile();
+    state_.assign(inner_->stateSize(), 0.0f);
+    const ModelSignature& signature = inner_->getSignature();
+    control_values_ = kAmplitudeSize + signature.num_harmonics + signature.num_noise_amps;
+    reset();
+    return loaded;
+}
+
+void MemoizedControlModel::reset() {
+    inner_->reset();
+    inner_stale_ = false;
+    key_ = kFnvOffset;
+}
+
+bool MemoizedControlModel::getState(float* dst, size_t size) const {
+    if (!inner_stale_) {
+        return inner_->getState(dst, size);
+    }
+    if (size != state_.size()) {
+        return false;
+    }
+    std::copy(state_.begin(), state_.end(), dst);
+    return true;
+}
+
+bool MemoizedControlModel::setState(const float* src, size_t size) {
+    if (!inner_->setState(src, size)) {
+        return false;
+    }
+    inner_stale_ = false;
+
+    // History is unknown; the state itself identifies the prefix
+    key_ = fnv1a(src, size * sizeof(float), kFnvOffset ^ 0x9e3779b97f4a7c15ull);
+    return true;
+}
+
+size_t MemoizedControlModel::entryBytes() const {
+    return (control_values_ + state_.size()) * sizeof(float) + kEntryOverheadBytes;
+}
+
+bool MemoizedControlModel::invoke(const AudioFeatures& input, SynthesisControls& output) {
+    if (!inner_->isLoaded()) {
+        return false;
+    }
+
+    // Quantise so equal keys always mean equal model inputs
+    const uint32_t q[2] = {
+        static_cast<uint32_t>(std::lround(std::clamp(input.f0_norm, 0.0f, 1.0f) * quantisation_steps_)),
+        static_cast<uint32_t>(std::lround(std::clamp(input.loudness_norm, 0.0f, 1.0f) * quantisation_steps_))};
+    const uint64_t key = fnv1a(q, sizeof(q), key_);
+    key_ = key;
+
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, found->second);
+        const std::vector<float>& values = found->second->values;
+
+        output.amplitude = values[0];
+        const auto noise_begin = values.begin() + kAmplitudeSize + output.harmonics.size();
+        std::copy(values.begin() + kAmplitudeSize, noise_begin, output.harmonics.begin());
+        std::copy(noise_begin, values.begin() + control_values_, output.noiseAmps.begin());
+        output.f0_hz = input.f0_hz;
+
+        std::copy(values.begin() + control_values_, values.end(), state_.begin());
+        inner_stale_ = true;
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (inner_stale_) {
+        inner_->setState(state_.data(), state_.size());
+        inner_stale_ = false;
+    }
+
+    AudioFeatures quantised = input;
+    quantised.f0_norm = static_cast<float>(q[0]) / quantisation_steps_;
+    quantised.loudness_norm = static_cast<float>(q[1]) / quantisation_steps_;
+
+    // call() keeps the inner model's timing meaningful (misses only)
+    if (!inner_->call(quantised, output)) {
+        setLastError(inner_->getLastError());
+        return false;
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    insert(key, output);
+    return true;
+}
+
+void MemoizedControlModel::insert(uint64_t key, const SynthesisControls& output) {
+    const size_t entry_bytes = entryBytes();
+    if (entry_bytes > budget_bytes_) {
+        return;
+    }
+
+    // Reuse the evicted entry's storage where possible
+    std::vector<float> values;
+    while (bytes_ + entry_bytes > budget_bytes_ && !lru_.empty()) {
+        index_.erase(lru_.back().key);
+        values = std::move(lru_.back().values);
+        lru_.pop_back();
+        bytes_ -= entry_bytes;
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    values.resize(control_values_ + state_.size());
+    values[0] = output.amplitude;
+    std::copy(output.harmonics.begin(), output.harmonics.end(), values.begin() + kAmplitudeSize);
+    std::copy(output.noiseAmps.begin(), output.noiseAmps.end(), values.begin() + kAmplitudeSize + output.harmonics.size());
+    inner_->getState(values.data() + control_values_, state_.size());
+
+    lru_.push_front(Entry{key, std::move(values)});
+    index_[key] = lru_.begin();
+    bytes_ += entry_bytes;
+    publishFootprint();
+}
+
+void MemoizedControlModel::clearCache() {
+    lru_.clear();
+    index_.clear();
+    bytes_ = 0;
+    publishFootprint();
+}
+
+void MemoizedControlModel::publishFootprint() {
+    entries_.store(lru_.size(), std::memory_order_relaxed);
+    bytes_published_.store(bytes_, std::memory_order_relaxed);
+}
+
+MemoizedControlModel::CacheStats MemoizedControlModel::getCacheStats() const {
+    CacheStats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.evictions = evictions_.load(std::memory_order_relaxed);
+    stats.entries = entries_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_published_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace ddsp
@@ -0,0 +1,128 @@
+#include "ModelBlob.h"
+#include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ddsp {
+
+namespace {
+
+bool readFile(const std::string& path, std::vector<uint8_t>& data) {
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream) {
+        return false;
+    }
+    const std::streamsize size = stream.tellg();
+    if (size <= 0) {
+        return false;
+    }
+    data.resize(static_cast<size_t>(size));
+    stream.seekg(0);
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(data.data()), size));
+}
+
+} // namespace
+
+ModelBlob::~ModelBlob() {
+    if (!mapped_) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(static_cast<HANDLE>(mapping_handle_));
+    CloseHandle(static_cast<HANDLE>(file_handle_));
+#else
+    munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+}
+
+std::shared_ptr<const ModelBlob> ModelBlob::mapFile(const std::string& path) {
+    std::shared_ptr<ModelBlob> blob(new ModelBlob());
+    blob->path_ = path;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER size = {};
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        }
+        void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (view) {
+            blob->data_ = static_cast<const uint8_t*>(view);
+            blob->size_ = static_cast<size_t>(size.QuadPart);
+            blob->file_handle_ = file;
+            blob->mapping_handle_ = mapping;
+            blob->mapped_ = true;
+            return blob;
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+    }
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat info = {};
+        void* region = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            region = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);  // The mapping keeps the file referenced
+        if (region != MAP_FAILED) {
+            blob->data_ = static_cast<const uint8_t*>(region);
+            blob->size_ = static_cast<size_t>(info.st_size);
+            blob->mapped_ = true;
+            return blob;
+        }
+    }
+#endif
+
+    // Mapping unavailable (e.g. Android assets, exotic filesystems)
+    if (!readFile(path, blob->owned_)) {
+        return nullptr;
+    }
+    blob->data_ = blob->owned_.data();
+    blob->size_ = blob->owned_.size();
+    return blob;
+}
+
+std::shared_ptr<const ModelBlob> ModelBlob::wrap(const void* data, size_t size,
+                                                std::shared_ptr<const void> owner) {
+    if (!data || size == 0) {
+        return nullptr;
+    }
+    std::shared_ptr<ModelBlob> blob(new ModelBlob());
+    blob->data_ = static_cast<const uint8_t*>(data);
+    blob->size_ = size;
+    blob->owner_ = std::move(owner);
+    return blob;
+}
+
+std::shared_ptr<const ModelBlob> ModelBlob::copyOf(const void* data, size_t size) {
+    if (!data || size == 0) {
+        return nullptr;
+    }
+    std::shared_ptr<ModelBlob> blob(new ModelBlob());
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    blob->owned_.assign(bytes, bytes + size);
+    blob->data_ = blob->owned_.data();
+    blob->size_ = blob->owned_.size();
+    return blob;
+}
+
+} // namespace ddsp
@@ -0,0 +1,265 @@
+#include "ModelRegistry.h"
+#include <iostream>
+
+namespace ddsp {
+
+ModelRegistry::ModelRegistry()
+    : ModelRegistry(Config())
+{
+}
+
+ModelRegistry::ModelRegistry(const Config& config)
+    : config_(config)
+{
+    prefetch_thread_ = std::thread([this]() { prefetchLoop(); });
+}
+
+ModelRegistry::~ModelRegistry() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    prefetch_cv_.notify_all();
+    if (prefetch_thread_.joinable()) {
+        prefetch_thread_.join();
+    }
+}
+
+void ModelRegistry::registerModel(const std::string& id, const std::string& model_path) {
+    std::vector<std::unique_ptr<IControlModel>> garbage;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Entry& entry = entries_[id];
+    if (entry.path != model_path) {
+        // Cached data belongs to the previous file
+        for (auto& model : entry.idle) {
+            garbage.push_back(std::move(model));
+        }
+        entry.idle.clear();
+        entry.blob.reset();
+        entry.path = model_path;
+    }
+}
+
+std::shared_ptr<const ModelBlob> ModelRegistry::mapBlob(const std::string& id) {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(id);
+        if (it == entries_.end()) {
+            return nullptr;
+        }
+        if (it->second.blob) {
+            return it->second.blob;
+        }
+        path = it->second.path;
+    }
+
+    // Map outside the lock; a racing mapper wins and this copy is dropped
+    auto blob = ModelBlob::mapFile(path);
+    if (!blob) {
+        std::cerr << "ModelRegistry: failed to read model file: " << path << std::endl;
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it != entries_.end() && it->second.path == path) {
+        if (!it->second.blob) {
+            it->second.blob = blob;
+        }
+        return it->second.blob;
+    }
+    return blob;
+}
+
+std::unique_ptr<IControlModel> ModelRegistry::createModel(const std::shared_ptr<const ModelBlob>& blob) {
+    auto model = createControlModel(config_.backend);
+    if (!model) {
+        std::cerr << "ModelRegistry: inference backend not available in this build: "
+                  << controlModelBackendName(resolveControlModelBackend(config_.backend)) << std::endl;
+        return nullptr;
+    }
+    if (!model->loadModelFromBlob(blob, config_.load_options)) {
+        return nullptr;
+    }
+    return model;
+}
+
+std::unique_ptr<IControlModel> ModelRegistry::acquire(const std::string& id) {
+    std::vector<std::unique_ptr<IControlModel>> garbage;
+    std::unique_ptr<IControlModel> idle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(id);
+        if (it == entries_.end()) {
+            std::cerr << "ModelRegistry: unknown instrument: " << id << std::endl;
+            return nullptr;
+        }
+
+        Entry& entry = it->second;
+        entry.last_used = ++clock_;
+        if (!entry.idle.empty()) {
+            idle = std::move(entry.idle.back());
+            entry.idle.pop_back();
+            stats_.hits++;
+        } else if (entry.blob) {
+            stats_.blob_hits++;
+        } else {
+            stats_.misses++;
+        }
+    }
+
+    // Idle interpreters gave their threads back; lease again outside the lock
+    if (idle) {
+        if (idle->acquireThreads()) {
+            return idle;
+        }
+        std::cerr << "ModelRegistry: failed to reactivate cached model: " << id << std::endl;
+        idle.reset();
+    }
+
+    auto blob = mapBlob(id);
+    if (!blob) {
+        return nullptr;
+    }
+    auto model = createModel(blob);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    enforceBudgetLocked(garbage);
+    return model;
+}
+
+void ModelRegistry::release(const std::string& id, std::unique_ptr<IControlModel> model) {
+    if (!model) {
+        return;
+    }
+    model->reset();
+    model->releaseThreads();  // Idle models do not hold scheduler threads
+
+    std::vector<std::unique_ptr<IControlModel>> garbage;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = entries_.find(id);
+    if (it == entries_.end() || !model->isLoaded() ||
+        static_cast<int>(it->second.idle.size()) >= config_.max_idle_per_model) {
+        garbage.push_back(std::move(model));
+        return;
+    }
+
+    it->second.idle.push_back(std::move(model));
+    it->second.last_used = ++clock_;
+    enforceBudgetLocked(garbage);
+}
+
+void ModelRegistry::prefetch(const std::string& id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        prefetch_queue_.push_back(id);
+    }
+    prefetch_cv_.notify_one();
+}
+
+void ModelRegistry::prefetchLoop() {
+    while (true) {
+        std::string id;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            prefetch_cv_.wait(lock, [this]() { return stopping_ || !prefetch_queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            id = std::move(prefetch_queue_.front());
+            prefetch_queue_.pop_front();
+
+            auto it = entries_.find(id);
+            if (it == entries_.end() || !it->second.idle.empty()) {
+                continue;  // Unknown, or already warm
+            }
+        }
+
+        auto blob = mapBlob(id);
+        auto model = blob ? createModel(blob) : nullptr;
+        if (model) {
+            model->releaseThreads();  // Leased again on acquire()
+        }
+
+        std::vector<std::unique_ptr<IControlModel>> garbage;
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.prefetches++;
+
+        auto it = entries_.find(id);
+        if (model && it != entries_.end() &&
+            static_cast<int>(it->second.idle.size()) < config_.max_idle_per_model) {
+            it->second.idle.push_back(std::move(model));
+            it->second.last_used = ++clock_;
+        } else if (model) {
+            garbage.push_back(std::move(model));
+        }
+        enforceBudgetLocked(garbage);
+    }
+}
+
+void ModelRegistry::setMemoryBudget(size_t bytes) {
+    std::vector<std::unique_ptr<IControlModel>> garbage;
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_.memory_budget_bytes = bytes;
+    enforceBudgetLocked(garbage);
+}
+
+size_t ModelRegistry::residentBytesLocked() const {
+    size_t bytes = 0;
+    for (const auto& [id, entry] : entries_) {
+        if (entry.blob) {
+            // Each idle interpreter is estimated at one model's worth of memory
+            bytes += entry.blob->size() * (1 + entry.idle.size());
+        }
+    }
+    return bytes;
+}
+
+void ModelRegistry::enforceBudgetLocked(std::vector<std::unique_ptr<IControlModel>>& garbage) {
+    while (residentBytesLocked() > config_.memory_budget_bytes) {
+        // Idle interpreters first: they are the most expensive to keep
+        Entry* victim = nullptr;
+        for (auto& [id, entry] : entries_) {
+            if (!entry.idle.empty() && (!victim || entry.last_used < victim->last_used)) {
+                victim = &entry;
+            }
+        }
+        if (victim) {
+            garbage.push_back(std::move(victim->idle.back()));
+            victim->idle.pop_back();
+            stats_.evictions++;
+            continue;
+        }
+
+        // Then mapped files no interpreter still references
+        for (auto& [id, entry] : entries_) {
+            if (entry.blob && entry.blob.use_count() == 1 &&
+                (!victim || entry.last_used < victim->last_used)) {
+                victim = &entry;
+            }
+        }
+        if (!victim) {
+            break;  // Everything left is in use
+        }
+        victim->blob.reset();
+        stats_.evictions++;
+    }
+}
+
+ModelRegistry::Stats ModelRegistry::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.resident_bytes = residentBytesLocked();
+    stats.cached_blobs = 0;
+    stats.idle_interpreters = 0;
+    for (const auto& [id, entry] : entries_) {
+        stats.cached_blobs += entry.blob ? 1 : 0;
+        stats.idle_interpreters += entry.idle.size();
+    }
+    return stats;
+}
+
+} // namespace ddsp
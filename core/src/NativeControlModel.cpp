@@ -0,0 +1,284 @@
+#include "NativeControlModel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace ddsp {
+
+namespace {
+
+constexpr char kNativeMagic[8] = {'D', 'D', 'S', 'P', 'N', 'A', 'T', 'V'};
+constexpr uint32_t kNativeVersion = 1;
+
+constexpr float kLeakyReluAlpha = 0.2f;
+constexpr float kLayerNormEpsilon = 1e-3f;
+constexpr float kNoiseInitialBias = -5.0f;
+
+// ddsp.core.exp_sigmoid(x, exponent=10.0, max_value=2.0, threshold=1e-7)
+inline float expSigmoid(float x) {
+    const float sigmoid = 1.0f / (1.0f + std::exp(-x));
+    return 2.0f * std::pow(sigmoid, std::log(10.0f)) + 1e-7f;
+}
+
+inline float sigmoid(float x) {
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+// out[j] = bias[j] + sum_i in[i] * kernel[i][j]
+void matVec(const float* in, int in_size, const float* kernel, const float* bias, float* out, int out_size) {
+    std::copy(bias, bias + out_size, out);
+    for (int i = 0; i < in_size; ++i) {
+        const float x = in[i];
+        const float* row = kernel + static_cast<size_t>(i) * out_size;
+        for (int j = 0; j < out_size; ++j) {
+            out[j] += x * row[j];
+        }
+    }
+}
+
+class WeightReader {
+public:
+    explicit WeightReader(std::ifstream& stream) : stream_(stream) {}
+
+    bool readU32(uint32_t& value) {
+        return static_cast<bool>(stream_.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    bool readFloats(std::vector<float>& dst, size_t count) {
+        dst.resize(count);
+        return static_cast<bool>(stream_.read(reinterpret_cast<char*>(dst.data()), sizeof(float) * count));
+    }
+
+private:
+    std::ifstream& stream_;
+};
+
+} // namespace
+
+NativeControlModel::NativeControlModel()
+    : model_loaded_(false)
+    , gru_size_(0)
+    , num_harmonics_(0)
+    , num_noise_amps_(0)
+{
+}
+
+bool NativeControlModel::loadModel(const std::string& model_path, const ModelLoadOptions& options) {
+    const auto load_start = std::chrono::steady_clock::now();
+    model_loaded_ = false;
+    startup_profile_ = StartupProfile{};
+
+    std::ifstream stream(model_path, std::ios::binary);
+    if (!stream) {
+        std::cerr << "Failed to open native weights: " << model_path << std::endl;
+        return false;
+    }
+
+    char magic[8] = {};
+    if (!stream.read(magic, sizeof(magic)) || std::memcmp(magic, kNativeMagic, sizeof(magic)) != 0) {
+        std::cerr << "Not a native DDSP weight file: " << model_path << std::endl;
+        return false;
+    }
+
+    WeightReader reader(stream);
+    uint32_t version = 0;
+    uint32_t input_layers = 0, input_channels = 0, gru_size = 0;
+    uint32_t output_layers = 0, output_channels = 0, num_harmonics = 0, num_noise_amps = 0;
+
+    if (!reader.readU32(version) || version != kNativeVersion ||
+        !reader.readU32(input_layers) || !reader.readU32(input_channels) ||
+        !reader.readU32(gru_size) || !reader.readU32(output_layers) ||
+        !reader.readU32(output_channels) || !reader.readU32(num_harmonics) ||
+        !reader.readU32(num_noise_amps)) {
+        std::cerr << "Unsupported native weight header in: " << model_path << std::endl;
+        return false;
+    }
+
+    if (input_layers == 0 || output_layers == 0 || gru_size == 0 ||
+        static_cast<int>(num_harmonics) != kHarmonicsSize ||
+        static_cast<int>(num_noise_amps) != kNoiseAmpsSize) {
+        std::cerr << "Native weight shapes do not match this build" << std::endl;
+        return false;
+    }
+
+    auto readStack = [&](std::vector<FcLayer>& stack, int layers, int in_size, int channels) {
+        stack.assign(layers, FcLayer{});
+        for (auto& layer : stack) {
+            layer.in_size = in_size;
+            layer.out_size = channels;
+            if (!reader.readFloats(layer.kernel, static_cast<size_t>(in_size) * channels) ||
+                !reader.readFloats(layer.bias, channels) ||
+                !reader.readFloats(layer.gamma, channels) ||
+                !reader.readFloats(layer.beta, channels)) {
+                return false;
+            }
+            in_size = channels;
+        }
+        return true;
+    };
+
+    const int ch = static_cast<int>(input_channels);
+    const int gru = static_cast<int>(gru_size);
+    const int out_ch = static_cast<int>(output_channels);
+    const int num_outputs = kAmplitudeSize + kHarmonicsSize + kNoiseAmpsSize;
+
+    bool ok = readStack(f0_stack_, input_layers, kF0Size, ch) &&
+              readStack(loudness_stack_, input_layers, kLoudnessSize, ch) &&
+              reader.readFloats(gru_kernel_, static_cast<size_t>(2 * ch) * 3 * gru) &&
+              reader.readFloats(gru_recurrent_kernel_, static_cast<size_t>(gru) * 3 * gru) &&
+              reader.readFloats(gru_input_bias_, 3 * gru) &&
+              reader.readFloats(gru_recurrent_bias_, 3 * gru) &&
+              readStack(output_stack_, output_layers, 2 * ch + gru, out_ch) &&
+              reader.readFloats(dense_out_kernel_, static_cast<size_t>(out_ch) * num_outputs) &&
+              reader.readFloats(dense_out_bias_, num_outputs);
+
+    if (!ok) {
+        std::cerr << "Truncated native weight file: " << model_path << std::endl;
+        return false;
+    }
+
+    startup_profile_.file_read_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+
+    gru_size_ = gru;
+    num_harmonics_ = static_cast<int>(num_harmonics);
+    num_noise_amps_ = static_cast<int>(num_noise_amps);
+
+    // Allocate all working memory up front
+    const int scratch_size = std::max(ch, out_ch);
+    state_.assign(gru, 0.0f);
+    f0_features_.assign(ch, 0.0f);
+    loudness_features_.assign(ch, 0.0f);
+    gru_input_.assign(2 * ch, 0.0f);
+    gru_x_.assign(3 * gru, 0.0f);
+    gru_h_.assign(3 * gru, 0.0f);
+    output_input_.assign(2 * ch + gru, 0.0f);
+    scratch_a_.assign(scratch_size, 0.0f);
+    scratch_b_.assign(scratch_size, 0.0f);
+    raw_output_.assign(num_outputs, 0.0f);
+
+    model_loaded_ = true;
+    warmUp(options.warmup_invocations);
+    startup_profile_.total_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+
+    std::cout << "Native model loaded (gru " << gru << ", " << input_layers << "+"
+              << output_layers << " fc layers of " << ch << "/" << out_ch << ")" << std::endl;
+    return true;
+}
+
+void NativeControlModel::reset() {
+    std::fill(state_.begin(), state_.end(), 0.0f);
+}
+
+void NativeControlModel::runFcLayer(const FcLayer& layer, const float* input, float* output) {
+    matVec(input, layer.in_size, layer.kernel.data(), layer.bias.data(), output, layer.out_size);
+
+    // LayerNorm over the channel axis
+    float mean = 0.0f;
+    for (int j = 0; j < layer.out_size; ++j) {
+        mean += output[j];
+    }
+    mean /= static_cast<float>(layer.out_size);
+
+    float variance = 0.0f;
+    for (int j = 0; j < layer.out_size; ++j) {
+        float d = output[j] - mean;
+        variance += d * d;
+    }
+    variance /= static_cast<float>(layer.out_size);
+
+    const float inv_std = 1.0f / std::sqrt(variance + kLayerNormEpsilon);
+    for (int j = 0; j < layer.out_size; ++j) {
+        float y = (output[j] - mean) * inv_std * layer.gamma[j] + layer.beta[j];
+        output[j] = y >= 0.0f ? y : kLeakyReluAlpha * y;
+    }
+}
+
+const float* NativeControlModel::runStack(const std::vector<FcLayer>& stack, const float* input) {
+    float* buffers[2] = {scratch_a_.data(), scratch_b_.data()};
+    const float* current = input;
+    for (size_t l = 0; l < stack.size(); ++l) {
+        float* out = buffers[l % 2];
+        runFcLayer(stack[l], current, out);
+        current = out;
+    }
+    return current;
+}
+
+void NativeControlModel::runGru(const float* input) {
+    const int gru = gru_size_;
+    matVec(input, static_cast<int>(gru_input_.size()), gru_kernel_.data(), gru_input_bias_.data(), gru_x_.data(), 3 * gru);
+    matVec(state_.data(), gru, gru_recurrent_kernel_.data(), gru_recurrent_bias_.data(), gru_h_.data(), 3 * gru);
+
+    for (int j = 0; j < gru; ++j) {
+        const float z = sigmoid(gru_x_[j] + gru_h_[j]);
+        const float r = sigmoid(gru_x_[gru + j] + gru_h_[gru + j]);
+        const float hh = std::tanh(gru_x_[2 * gru + j] + r * gru_h_[2 * gru + j]);
+        state_[j] = z * state_[j] + (1.0f - z) * hh;
+    }
+}
+
+bool NativeControlModel::invoke(const AudioFeatures& input, SynthesisControls& output) {
+    if (!model_loaded_) {
+        return false;
+    }
+
+    const int ch = static_cast<int>(f0_features_.size());
+
+    const float* f0_out = runStack(f0_stack_, &input.f0_norm);
+    std::copy(f0_out, f0_out + ch, f0_features_.begin());
+
+    const float* loudness_out = runStack(loudness_stack_, &input.loudness_norm);
+    std::copy(loudness_out, loudness_out + ch, loudness_features_.begin());
+
+    // GRU over concatenated input features
+    std::copy(f0_features_.begin(), f0_features_.end(), gru_input_.begin());
+    std::copy(loudness_features_.begin(), loudness_features_.end(), gru_input_.begin() + ch);
+    runGru(gru_input_.data());
+
+    // Output stack sees the input features alongside the GRU output
+    std::copy(gru_input_.begin(), gru_input_.end(), output_input_.begin());
+    std::copy(state_.begin(), state_.end(), output_input_.begin() + 2 * ch);
+    const float* hidden = runStack(output_stack_, output_input_.data());
+
+    const int out_ch = output_stack_.back().out_size;
+    matVec(hidden, out_ch, dense_out_kernel_.data(), dense_out_bias_.data(),
+           raw_output_.data(), static_cast<int>(raw_output_.size()));
+
+    output.amplitude = expSigmoid(raw_output_[0]);
+    for (int h = 0; h < num_harmonics_; ++h) {
+        output.harmonics[h] = expSigmoid(raw_output_[kAmplitudeSize + h]);
+    }
+    for (int n = 0; n < num_noise_amps_; ++n) {
+        output.noiseAmps[n] = expSigmoid(raw_output_[kAmplitudeSize + num_harmonics_ + n] + kNoiseInitialBias);
+    }
+
+    output.f0_hz = input.f0_hz;
+    return true;
+}
+
+size_t NativeControlModel::stateSize() const {
+    return state_.size();
+}
+
+bool NativeControlModel::getState(float* dst, size_t size) const {
+    if (size != state_.size()) {
+        return false;
+    }
+    std::copy(state_.begin(), state_.end(), dst);
+    return true;
+}
+
+bool NativeControlModel::setState(const float* src, size_t size) {
+    if (size != state_.size()) {
+        return false;
+    }
+    std::copy(src, src + size, state_.begin());
+    return true;
+}
+
+} // namespace ddsp
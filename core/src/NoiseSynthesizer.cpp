@@ -6,14 +6,28 @@ namespace ddsp {
 
 namespace {
     constexpr float kTwoPi = 2.0f * 3.14159265358979323846f;
+
+    // Smallest order with 2^order >= size
+    int fftOrder(int size) {
+        int order = 0;
+        while ((1 << order) < size) {
+            ++order;
+        }
+        return order;
+    }
+}
+
+bool NoiseSynthesizer::isSupportedBandCount(int num_noise_amps) {
+    const int bins = num_noise_amps - 1;
+    return bins >= 2 && (bins & (bins - 1)) == 0;
 }
 
 NoiseSynthesizer::NoiseSynthesizer(int num_noise_amps, int num_output_samples)
     : num_noise_amps_(num_noise_amps)
     , num_output_samples_(num_output_samples)
     , impulse_response_size_((num_noise_amps - 1) * 2)  // 128 for 65 bands
-    , window_fft_(7)    // 2^7 = 128 point FFT
-    , convolve_fft_(9)  // 2^9 = 512 point FFT
+    , window_fft_(fftOrder(impulse_response_size_))                         // 2^7 = 128 point FFT
+    , convolve_fft_(fftOrder(impulse_response_size_ + num_output_samples))  // 2^9 = 512 point FFT
     , rng_(std::random_device{}())
     , noise_dist_(-1.0f, 1.0f)
 {
@@ -34,6 +48,20 @@ void NoiseSynthesizer::reset() {
     std::fill(white_noise_.begin(), white_noise_.end(), 0.0f);
 }
 
+size_t NoiseSynthesizer::getMemoryBytes() const {
+    // JUCE keeps about one complex twiddle per point for each plan
+    const size_t plans = static_cast<size_t>(window_fft_.getSize() + convolve_fft_.getSize()) *
+                         sizeof(std::complex<float>);
+    return magnitudes_complex_.capacity() * sizeof(std::complex<float>) + plans +
+           (zp_hann_window_.capacity() + windowed_impulse_response_.capacity() + white_noise_.capacity() +
+            noise_audio_.capacity()) * sizeof(float);
+}
+
+void NoiseSynthesizer::seed(uint32_t value) {
+    rng_.seed(value);
+    noise_dist_.reset();
+}
+
 const std::vector<float>& NoiseSynthesizer::render(const std::vector<float>& magnitudes) {
     // Convert frequency magnitudes to time-domain FIR filter
     applyWindowToImpulseResponse(magnitudes);
@@ -0,0 +1,534 @@
+#include "OfflineRenderer.h"
+#include "InputUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+namespace ddsp {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+std::unique_ptr<IControlModel> createModel(const std::string& model_path, const ModelLoadOptions& options,
+                                           ControlModelBackend backend) {
+    auto model = createControlModel(backend);
+    if (!model) {
+        std::cerr << "Inference backend not available in this build: "
+                  << controlModelBackendName(resolveControlModelBackend(backend)) << std::endl;
+        return nullptr;
+    }
+    if (options.inference_cache_bytes > 0) {
+        model = std::make_unique<MemoizedControlModel>(
+            std::move(model), options.inference_cache_bytes, options.inference_cache_quantisation);
+    }
+    if (!model->loadModel(model_path, options)) {
+        std::cerr << "Failed to load DDSP model: " << model_path << std::endl;
+        return nullptr;
+    }
+    return model;
+}
+
+// Noise for frame n depends only on (seed, n), so any chunk can reproduce it
+uint32_t frameSeed(uint32_t seed, int64_t frame) {
+    const uint64_t mixed = static_cast<uint64_t>(frame) * 0x9E3779B97F4A7C15ull;
+    return seed ^ static_cast<uint32_t>(mixed >> 32);
+}
+
+} // namespace
+
+OfflineRenderer::OfflineRenderer()
+    : OfflineRenderer(Options())
+{
+}
+
+OfflineRenderer::OfflineRenderer(const Options& options)
+    : harmonic_synth_(std::make_unique<HarmonicSynthesizer>(kHarmonicsSize, kModelHopSize, kModelSampleRate_Hz))
+    , noise_synth_(std::make_unique<NoiseSynthesizer>(kNoiseAmpsSize, kModelHopSize))
+    , synthesis_buffer_(kModelHopSize, 0.0f)
+{
+    setOptions(options);
+}
+
+OfflineRenderer::~OfflineRenderer() = default;
+
+void OfflineRenderer::setOptions(const Options& options) {
+    options_ = options;
+    options_.sink_block_frames = std::max(options_.sink_block_frames, 1);
+    hop_size_ = static_cast<int>(options_.sample_rate * kModelHopSize / kModelSampleRate_Hz);
+    prepareResampler();
+    sink_buffer_.assign(static_cast<size_t>(hop_size_) * options_.sink_block_frames, 0.0f);
+}
+
+void OfflineRenderer::prepareResampler() {
+    // Polyphase only when every frame maps to exactly hop_size_ samples
+    const bool whole_hop = std::abs(options_.sample_rate * kModelHopSize / kModelSampleRate_Hz - hop_size_) < 1e-9;
+    if (!whole_hop ||
+        !resampler_.prepare(kModelSampleRate_Hz, options_.sample_rate, kModelHopSize, options_.resampler_quality)) {
+        resampler_ = PolyphaseResampler();
+    }
+}
+
+bool OfflineRenderer::loadModel(const std::string& model_path, const ModelLoadOptions& options,
+                                ControlModelBackend backend) {
+    auto model = createModel(model_path, options, backend);
+    if (!model || !adoptModel(std::move(model))) {
+        return false;
+    }
+
+    // Parallel workers each get their own copy, one core per chunk
+    ModelLoadOptions worker_options = options;
+    worker_options.num_threads = 1;
+    worker_options.autotune = false;
+    setModelFactory([model_path, worker_options, backend]() {
+        return createModel(model_path, worker_options, backend);
+    });
+    return true;
+}
+
+void OfflineRenderer::setModelFactory(ModelFactory factory) {
+    model_factory_ = std::move(factory);
+    workers_.clear();
+}
+
+bool OfflineRenderer::adoptModel(std::unique_ptr<IControlModel> model) {
+    model_.reset();
+    model_factory_ = nullptr;
+    workers_.clear();
+    if (!model || !model->isLoaded()) {
+        return false;
+    }
+
+    const ModelSignature& signature = model->getSignature();
+    if (signature.num_harmonics < 1 || !NoiseSynthesizer::isSupportedBandCount(signature.num_noise_amps)) {
+        std::cerr << "Unsupported model shape: " << signature.num_harmonics << " harmonics, "
+                  << signature.num_noise_amps << " noise bands" << std::endl;
+        return false;
+    }
+
+    if (harmonic_synth_->getNumHarmonics() != signature.num_harmonics) {
+        harmonic_synth_ = std::make_unique<HarmonicSynthesizer>(
+            signature.num_harmonics, kModelHopSize, kModelSampleRate_Hz);
+    }
+    if (noise_synth_->getNumNoiseAmps() != signature.num_noise_amps) {
+        noise_synth_ = std::make_unique<NoiseSynthesizer>(signature.num_noise_amps, kModelHopSize);
+    }
+    controls_.resize(signature.num_harmonics, signature.num_noise_amps);
+    harmonic_synth_->getState(harmonic_state_);
+
+    model_ = std::move(model);
+    return true;
+}
+
+std::unique_ptr<IControlModel> OfflineRenderer::releaseModel() {
+    return std::move(model_);
+}
+
+MemoizedControlModel::CacheStats OfflineRenderer::getInferenceCacheStats() const {
+    MemoizedControlModel::CacheStats total;
+    auto add = [&total](const IControlModel* model) {
+        auto* memoized = dynamic_cast<const MemoizedControlModel*>(model);
+        if (!memoized) {
+            return;
+        }
+        const auto stats = memoized->getCacheStats();
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.evictions += stats.evictions;
+        total.entries += stats.entries;
+        total.bytes += stats.bytes;
+    };
+    add(model_.get());
+    for (const auto& worker : workers_) {
+        add(worker->model_.get());
+    }
+    return total;
+}
+
+void OfflineRenderer::resetVoice() {
+    model_->reset();
+    harmonic_synth_->reset();
+    noise_synth_->reset();
+    resampler_.reset();
+    fallback_interpolator_.reset();
+}
+
+int64_t OfflineRenderer::render(const float* f0_hz, const float* loudness_norm, int64_t num_frames, float* output) {
+    if (!model_ || !output) {
+        return -1;
+    }
+    resetVoice();
+    return renderFrames(f0_hz, loudness_norm, nullptr, num_frames, output, nullptr);
+}
+
+int64_t OfflineRenderer::render(const float* f0_hz, const float* loudness_norm, int64_t num_frames,
+                                const Sink& sink) {
+    if (!model_ || !sink) {
+        return -1;
+    }
+    resetVoice();
+    return renderFrames(f0_hz, loudness_norm, nullptr, num_frames, nullptr, &sink);
+}
+
+int64_t OfflineRenderer::renderEvents(const std::vector<ControlEvent>& events, int64_t num_samples, float* output) {
+    if (!model_ || !output || hop_size_ <= 0) {
+        return -1;
+    }
+    const int64_t num_frames = (num_samples + hop_size_ - 1) / hop_size_;
+    eventsToFrames(events, num_frames, hop_size_, event_f0_, event_loudness_, event_note_on_);
+    resetVoice();
+    return renderFrames(event_f0_.data(), event_loudness_.data(), event_note_on_.data(), num_frames, output, nullptr,
+                        0, num_samples);
+}
+
+int64_t OfflineRenderer::renderEvents(const std::vector<ControlEvent>& events, int64_t num_samples,
+                                      const Sink& sink) {
+    if (!model_ || !sink || hop_size_ <= 0) {
+        return -1;
+    }
+    const int64_t num_frames = (num_samples + hop_size_ - 1) / hop_size_;
+    eventsToFrames(events, num_frames, hop_size_, event_f0_, event_loudness_, event_note_on_);
+    resetVoice();
+    return renderFrames(event_f0_.data(), event_loudness_.data(), event_note_on_.data(), num_frames, nullptr, &sink,
+                        0, num_samples);
+}
+
+void OfflineRenderer::eventsToFrames(const std::vector<ControlEvent>& events, int64_t num_frames, int hop_size,
+                                     std::vector<float>& f0_hz, std::vector<float>& loudness_norm,
+                                     std::vector<uint8_t>& note_on) {
+    f0_hz.assign(static_cast<size_t>(std::max<int64_t>(num_frames, 0)), 0.0f);
+    loudness_norm.assign(f0_hz.size(), 0.0f);
+    note_on.assign(f0_hz.size(), 0);
+
+    // Stable by time, so events at the same sample keep their order
+    std::vector<ControlEvent> sorted(events);
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const ControlEvent& a, const ControlEvent& b) { return a.sample_time < b.sample_time; });
+
+    float f0 = 440.0f;
+    float loudness = 0.0f;
+    size_t next = 0;
+
+    for (int64_t frame = 0; frame < num_frames; ++frame) {
+        const int64_t hop_start = frame * hop_size;
+        const int64_t hop_end = hop_start + hop_size;
+
+        // Integrate the piecewise-constant controls over the hop
+        double f0_sum = 0.0;
+        double loudness_sum = 0.0;
+        int64_t cursor = hop_start;
+
+        for (; next < sorted.size() && sorted[next].sample_time < hop_end; ++next) {
+            const ControlEvent& event = sorted[next];
+            if (event.flags & ControlEvent::kNoteOn) {
+                // The new note owns the hop from its start
+                f0_sum = 0.0;
+                loudness_sum = 0.0;
+                cursor = hop_start;
+                note_on[static_cast<size_t>(frame)] = 1;
+            } else if (event.sample_time > cursor) {
+                const double span = static_cast<double>(event.sample_time - cursor);
+                f0_sum += f0 * span;
+                loudness_sum += loudness * span;
+                cursor = event.sample_time;
+            }
+
+            if (event.flags & (ControlEvent::kF0 | ControlEvent::kNoteOn)) {
+                f0 = std::clamp(event.f0_hz, kPitchRangeMin_Hz, kPitchRangeMax_Hz);
+            }
+            if (event.flags & (ControlEvent::kLoudness | ControlEvent::kNoteOn)) {
+                loudness = std::clamp(event.loudness_norm, 0.0f, 1.0f);
+            }
+        }
+
+        const double span = static_cast<double>(hop_end - cursor);
+        f0_hz[static_cast<size_t>(frame)] = static_cast<float>((f0_sum + f0 * span) / hop_size);
+        loudness_norm[static_cast<size_t>(frame)] = static_cast<float>((loudness_sum + loudness * span) / hop_size);
+    }
+}
+
+int64_t OfflineRenderer::renderFrames(const float* f0_hz, const float* loudness_norm, const uint8_t* note_on,
+                                      int64_t num_frames, float* output, const Sink* sink, int64_t first_frame,
+                                      int64_t max_samples) {
+    stats_ = Stats();
+    const auto start = Clock::now();
+
+    const int64_t limit = max_samples >= 0 ? std::min(max_samples, num_frames * hop_size_) : num_frames * hop_size_;
+    int64_t produced = 0;
+    int block_frames = 0;
+    int block_samples = 0;
+    bool ok = true;
+
+    for (int64_t frame = 0; frame < num_frames && produced < limit; ++frame) {
+        const int frame_samples = static_cast<int>(std::min<int64_t>(hop_size_, limit - produced));
+
+        // Direct to the caller's buffer; through a block buffer for sinks
+        // and for a trimmed last frame, which would overrun the caller's buffer
+        const bool direct = output && frame_samples == hop_size_;
+        float* dst = direct ? output + produced
+                            : sink_buffer_.data() + static_cast<size_t>(block_frames) * hop_size_;
+
+        if (!renderFrame(f0_hz[frame], loudness_norm[frame], note_on && note_on[frame], first_frame + frame, dst)) {
+            ok = false;
+            break;
+        }
+        if (output && !direct) {
+            std::copy(dst, dst + frame_samples, output + produced);
+        }
+        produced += frame_samples;
+
+        if (sink) {
+            ++block_frames;
+            block_samples += frame_samples;
+            if (block_frames == options_.sink_block_frames) {
+                const bool more = (*sink)(sink_buffer_.data(), block_samples);
+                block_frames = 0;
+                block_samples = 0;
+                if (!more) {
+                    break;
+                }
+            }
+        }
+    }
+
+    if (sink && block_samples > 0) {
+        (*sink)(sink_buffer_.data(), block_samples);
+    }
+
+    stats_.frames = (produced + hop_size_ - 1) / std::max(hop_size_, 1);
+    stats_.samples = produced;
+    stats_.audio_seconds = static_cast<double>(produced) / options_.sample_rate;
+    stats_.render_seconds = secondsSince(start);
+    return ok ? produced : -1;
+}
+
+bool OfflineRenderer::renderFrame(float f0_hz, float loudness_norm, bool note_on, int64_t frame, float* dst) {
+    // --- MODEL INPUT ---
+    f0_hz = offsetPitch(f0_hz, options_.pitch_shift_semitones);
+    features_.f0_hz = f0_hz;
+    features_.f0_norm = normalizedPitch(f0_hz);
+    features_.loudness_norm = loudness_norm;
+    features_.loudness_db = denormalizeLoudness(loudness_norm);
+
+    // --- RUN MODEL INFERENCE ---
+    const auto inference_start = Clock::now();
+    const bool inferred = model_->call(features_, controls_);
+    stats_.inference_seconds += secondsSince(inference_start);
+    if (!inferred) {
+        return false;
+    }
+
+    controls_.amplitude *= options_.harmonic_gain;
+    for (auto& amp : controls_.noiseAmps) {
+        amp *= options_.noise_gain;
+    }
+
+    if (note_on) {
+        // Keep the phase, but start the new note at its own pitch
+        harmonic_synth_->getState(harmonic_state_);
+        harmonic_state_.f0 = controls_.f0_hz;
+        harmonic_synth_->setState(harmonic_state_);
+    }
+
+    // --- SYNTHESIZE AUDIO ---
+    const auto& harmonic_output = harmonic_synth_->render(controls_.harmonics, controls_.amplitude, controls_.f0_hz);
+    noise_synth_->seed(frameSeed(options_.noise_seed, frame));
+    const auto& noise_output = noise_synth_->render(controls_.noiseAmps);
+    for (int i = 0; i < kModelHopSize; ++i) {
+        synthesis_buffer_[static_cast<size_t>(i)] = harmonic_output[static_cast<size_t>(i)] +
+                                                    noise_output[static_cast<size_t>(i)];
+    }
+
+    // --- UPSAMPLE TO OUTPUT RATE ---
+    if (resampler_.isPrepared()) {
+        resampler_.process(synthesis_buffer_.data(), kModelHopSize, dst);
+    } else {
+        fallback_interpolator_.process(kModelSampleRate_Hz / options_.sample_rate,
+                                       synthesis_buffer_.data(), dst, hop_size_);
+    }
+    return true;
+}
+
+bool OfflineRenderer::prepareWorkers(int count) {
+    while (static_cast<int>(workers_.size()) < count) {
+        auto worker = std::make_unique<OfflineRenderer>(options_);
+        if (!worker->adoptModel(model_factory_())) {
+            std::cerr << "Failed to create a model for parallel rendering" << std::endl;
+            return false;
+        }
+        workers_.push_back(std::move(worker));
+    }
+    for (auto& worker : workers_) {
+        worker->setOptions(options_);
+    }
+    return true;
+}
+
+int64_t OfflineRenderer::renderChunk(const float* f0_hz, const float* loudness_norm, int64_t first_frame,
+                                     int64_t num_frames, const HarmonicSynthesizer::State& harmonic_state,
+                                     float* output) {
+    resetVoice();
+    harmonic_synth_->setState(harmonic_state);
+    return renderFrames(f0_hz + first_frame, loudness_norm + first_frame, nullptr, num_frames, output, nullptr,
+                        first_frame);
+}
+
+int64_t OfflineRenderer::renderParallel(const float* f0_hz, const float* loudness_norm, int64_t num_frames,
+                                        float* output, const ParallelOptions& options) {
+    parallel_stats_ = ParallelStats();
+    if (!model_ || !output || num_frames <= 0) {
+        return model_ && output ? 0 : -1;
+    }
+
+    const int64_t chunk_frames = std::max(options.chunk_frames, 1);
+    const int64_t warmup_frames = std::max(options.warmup_frames, 0);
+    const int64_t crossfade_frames = std::clamp<int64_t>(options.crossfade_frames, 0, warmup_frames);
+    const int num_chunks = static_cast<int>((num_frames + chunk_frames - 1) / chunk_frames);
+
+    int num_threads = options.num_threads > 0 ? options.num_threads
+                                              : static_cast<int>(std::thread::hardware_concurrency());
+    num_threads = std::clamp(num_threads, 1, num_chunks);
+    if (!model_factory_) {
+        num_threads = 1;  // Nothing to give the other threads
+    }
+
+    struct Chunk {
+        int64_t warmup_start = 0;    // First rendered frame
+        int64_t start = 0;           // First frame this chunk owns
+        int64_t end = 0;
+        int64_t crossfade = 0;       // Warm-up frames blended into the previous chunk
+        HarmonicSynthesizer::State harmonic;
+        std::vector<float> crossfade_audio;
+        double render_seconds = 0.0;
+        double inference_seconds = 0.0;
+        bool ok = false;
+    };
+
+    std::vector<Chunk> chunks(static_cast<size_t>(num_chunks));
+    for (int k = 0; k < num_chunks; ++k) {
+        Chunk& chunk = chunks[static_cast<size_t>(k)];
+        chunk.start = k * chunk_frames;
+        chunk.end = std::min(chunk.start + chunk_frames, num_frames);
+        chunk.warmup_start = std::max<int64_t>(chunk.start - warmup_frames, 0);
+        chunk.crossfade = std::min(crossfade_frames, chunk.start - chunk.warmup_start);
+    }
+
+    const auto start = Clock::now();
+
+    // --- HARMONIC PHASE at each warm-up start (f0 only, no synthesis) ---
+    harmonic_synth_->reset();
+    int64_t frame = 0;
+    for (Chunk& chunk : chunks) {
+        for (; frame < chunk.warmup_start; ++frame) {
+            harmonic_synth_->advancePhase(offsetPitch(f0_hz[frame], options_.pitch_shift_semitones));
+        }
+        harmonic_synth_->getState(chunk.harmonic);
+    }
+
+    if (num_threads > 1 && !prepareWorkers(num_threads - 1)) {
+        return -1;
+    }
+
+    // --- RENDER CHUNKS (this renderer is worker 0) ---
+    std::atomic<int> next_chunk{0};
+    auto work = [&](OfflineRenderer& renderer) {
+        std::vector<float> scratch;
+        for (int k = next_chunk.fetch_add(1); k < num_chunks; k = next_chunk.fetch_add(1)) {
+            Chunk& chunk = chunks[static_cast<size_t>(k)];
+            const int64_t rendered_frames = chunk.end - chunk.warmup_start;
+            scratch.resize(static_cast<size_t>(rendered_frames * hop_size_));
+
+            chunk.ok = renderer.renderChunk(f0_hz, loudness_norm, chunk.warmup_start, rendered_frames,
+                                            chunk.harmonic, scratch.data()) >= 0;
+            chunk.render_seconds = renderer.stats_.render_seconds;
+            chunk.inference_seconds = renderer.stats_.inference_seconds;
+            if (!chunk.ok) {
+                continue;
+            }
+
+            // Owned frames go straight to the output (chunks never overlap there)
+            const int64_t skip = (chunk.start - chunk.warmup_start) * hop_size_;
+            std::copy(scratch.begin() + skip, scratch.end(), output + chunk.start * hop_size_);
+            chunk.crossfade_audio.assign(scratch.begin() + skip - chunk.crossfade * hop_size_,
+                                         scratch.begin() + skip);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < num_threads; ++t) {
+        threads.emplace_back(work, std::ref(*workers_[static_cast<size_t>(t - 1)]));
+    }
+    work(*this);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // --- CROSSFADE warm-up tails into the previous chunk's output ---
+    bool ok = true;
+    for (const Chunk& chunk : chunks) {
+        ok = ok && chunk.ok;
+        const int64_t length = static_cast<int64_t>(chunk.crossfade_audio.size());
+        float* dst = output + chunk.start * hop_size_ - length;
+        for (int64_t i = 0; i < length; ++i) {
+            const float gain = (static_cast<float>(i) + 0.5f) / static_cast<float>(length);
+            dst[i] += gain * (chunk.crossfade_audio[static_cast<size_t>(i)] - dst[i]);
+        }
+    }
+
+    parallel_stats_.chunks = num_chunks;
+    parallel_stats_.threads = num_threads;
+    parallel_stats_.parallel_seconds = secondsSince(start);
+
+    stats_ = Stats();
+    stats_.frames = num_frames;
+    stats_.samples = num_frames * hop_size_;
+    stats_.audio_seconds = static_cast<double>(stats_.samples) / options_.sample_rate;
+    stats_.render_seconds = parallel_stats_.parallel_seconds;
+    for (const Chunk& chunk : chunks) {
+        stats_.inference_seconds += chunk.inference_seconds;
+        // Serial estimate: chunk time without its warm-up share
+        const double owned = static_cast<double>(chunk.end - chunk.start) /
+                             static_cast<double>(chunk.end - chunk.warmup_start);
+        parallel_stats_.serial_seconds += chunk.render_seconds * owned;
+    }
+
+    if (!ok) {
+        return -1;
+    }
+
+    // --- SERIAL REFERENCE ---
+    if (options.compare_serial) {
+        std::vector<float> serial(static_cast<size_t>(stats_.samples));
+        const Stats parallel = stats_;
+        if (render(f0_hz, loudness_norm, num_frames, serial.data()) < 0) {
+            return -1;
+        }
+        parallel_stats_.serial_seconds = stats_.render_seconds;
+        parallel_stats_.serial_measured = true;
+        stats_ = parallel;
+
+        double error_energy = 0.0;
+        double signal_energy = 0.0;
+        for (size_t i = 0; i < serial.size(); ++i) {
+            const double error = static_cast<double>(output[i]) - serial[i];
+            error_energy += error * error;
+            signal_energy += static_cast<double>(serial[i]) * serial[i];
+            parallel_stats_.max_abs_error = std::max(parallel_stats_.max_abs_error, std::abs(error));
+        }
+        parallel_stats_.error_db = 10.0 * std::log10(std::max(error_energy, 1e-30) / std::max(signal_energy, 1e-30));
+    }
+
+    if (parallel_stats_.parallel_seconds > 0.0) {
+        parallel_stats_.speedup = parallel_stats_.serial_seconds / parallel_stats_.parallel_seconds;
+    }
+    return stats_.samples;
+}
+
+} // namespace ddsp
@@ -0,0 +1,244 @@
+#include "OnnxControlModel.h"
+#include "InferenceScheduler.h"
+
+#include <onnxruntime_cxx_api.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ddsp {
+
+struct OnnxControlModel::Session {
+    Ort::SessionOptions options;
+    std::unique_ptr<Ort::Session> session;
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+    // Tensor names in DDSPTypes.h order: f0, loudness, state / amplitude, harmonics, noise, state
+    std::array<const char*, kNumPredictControlsInputTensors> input_names{};
+    std::array<const char*, kNumPredictControlsOutputTensors> output_names{};
+
+    // Host buffers bound to the Ort::Values below (no per-call allocation)
+    float f0 = 0.0f;
+    float loudness = 0.0f;
+    std::array<float, kGruModelStateSize> state_in{};
+    float amplitude = 0.0f;
+    std::array<float, kHarmonicsSize> harmonics{};
+    std::array<float, kNoiseAmpsSize> noise_amps{};
+    std::array<float, kGruModelStateSize> state_out{};
+
+    std::vector<Ort::Value> inputs;
+    std::vector<Ort::Value> outputs;
+};
+
+namespace {
+
+// One environment per process; its global intra-op pool is shared by all
+// sessions and sized from the inference thread budget on first use
+Ort::Env& sharedEnv() {
+    static Ort::Env env = [] {
+        Ort::ThreadingOptions threading;
+        threading.SetGlobalIntraOpNumThreads(InferenceScheduler::instance().getThreadBudget() + 1);
+        threading.SetGlobalInterOpNumThreads(1);
+        return Ort::Env(threading, ORT_LOGGING_LEVEL_WARNING, "ddsp");
+    }();
+    return env;
+}
+
+std::vector<int64_t> resolvedShape(const Ort::TypeInfo& info) {
+    auto shape = info.GetTensorTypeAndShapeInfo().GetShape();
+    for (auto& dim : shape) {
+        if (dim < 0) {
+            dim = 1;  // Dynamic batch/time dims run with a single frame
+        }
+    }
+    return shape;
+}
+
+} // namespace
+
+OnnxControlModel::OnnxControlModel()
+    : model_loaded_(false)
+{
+    gruState_.fill(0.0f);
+}
+
+OnnxControlModel::~OnnxControlModel() = default;
+
+bool OnnxControlModel::loadModel(const std::string& model_path, const ModelLoadOptions& options) {
+    return loadSession(model_path, nullptr, options);
+}
+
+bool OnnxControlModel::loadModelFromBlob(std::shared_ptr<const ModelBlob> blob, const ModelLoadOptions& options) {
+    if (!blob) {
+        return false;
+    }
+    return loadSession(blob->path().empty() ? "<memory>" : blob->path(), blob.get(), options);
+}
+
+bool OnnxControlModel::loadSession(const std::string& model_path, const ModelBlob* blob,
+                                   const ModelLoadOptions& options) {
+    const auto load_start = std::chrono::steady_clock::now();
+    model_loaded_ = false;
+    session_.reset();
+    startup_profile_ = StartupProfile{};
+
+    try {
+        auto session = std::make_unique<Session>();
+        // Threads come from the shared pool, not per session
+        if (InferenceScheduler::instance().getParallelismPolicy() == ParallelismPolicy::SingleThreaded) {
+            session->options.SetIntraOpNumThreads(1);
+        } else {
+            session->options.DisablePerSessionThreads();
+        }
+        session->options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+        if (blob) {
+            session->session = std::make_unique<Ort::Session>(
+                sharedEnv(), blob->data(), blob->size(), session->options);
+        } else {
+#ifdef _WIN32
+            std::wstring wide_path(model_path.begin(), model_path.end());
+            session->session = std::make_unique<Ort::Session>(sharedEnv(), wide_path.c_str(), session->options);
+#else
+            session->session = std::make_unique<Ort::Session>(sharedEnv(), model_path.c_str(), session->options);
+#endif
+        }
+        startup_profile_.interpreter_create_ms =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+
+        const std::string_view input_names[] = {
+            kInputTensorName_F0, kInputTensorName_Loudness, kInputTensorName_State};
+        const std::string_view output_names[] = {
+            kOutputTensorName_Amplitude, kOutputTensorName_Harmonics,
+            kOutputTensorName_NoiseAmps, kOutputTensorName_State};
+
+        // Map required names onto session indices
+        auto findIndex = [](std::string_view name, size_t count, auto getName) -> long {
+            for (size_t i = 0; i < count; ++i) {
+                if (getName(i) == name) {
+                    return static_cast<long>(i);
+                }
+            }
+            return -1;
+        };
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        std::vector<std::string> session_inputs, session_outputs;
+        for (size_t i = 0; i < session->session->GetInputCount(); ++i) {
+            session_inputs.emplace_back(session->session->GetInputNameAllocated(i, allocator).get());
+        }
+        for (size_t i = 0; i < session->session->GetOutputCount(); ++i) {
+            session_outputs.emplace_back(session->session->GetOutputNameAllocated(i, allocator).get());
+        }
+
+        float* input_buffers[] = {&session->f0, &session->loudness, session->state_in.data()};
+        const size_t input_sizes[] = {kF0Size, kLoudnessSize, kGruModelStateSize};
+        for (int i = 0; i < kNumPredictControlsInputTensors; ++i) {
+            long index = findIndex(input_names[i], session_inputs.size(),
+                                   [&](size_t k) { return std::string_view(session_inputs[k]); });
+            if (index < 0) {
+                std::cerr << "ONNX model is missing input: " << input_names[i] << std::endl;
+                return false;
+            }
+            auto shape = resolvedShape(session->session->GetInputTypeInfo(index));
+            session->input_names[i] = input_names[i].data();
+            session->inputs.push_back(Ort::Value::CreateTensor<float>(
+                session->memory_info, input_buffers[i], input_sizes[i], shape.data(), shape.size()));
+        }
+
+        float* output_buffers[] = {&session->amplitude, session->harmonics.data(),
+                                   session->noise_amps.data(), session->state_out.data()};
+        const size_t output_sizes[] = {kAmplitudeSize, kHarmonicsSize, kNoiseAmpsSize, kGruModelStateSize};
+        for (int i = 0; i < kNumPredictControlsOutputTensors; ++i) {
+            long index = findIndex(output_names[i], session_outputs.size(),
+                                   [&](size_t k) { return std::string_view(session_outputs[k]); });
+            if (index < 0) {
+                std::cerr << "ONNX model is missing output: " << output_names[i] << std::endl;
+                return false;
+            }
+            auto shape = resolvedShape(session->session->GetOutputTypeInfo(index));
+            session->output_names[i] = output_names[i].data();
+            session->outputs.push_back(Ort::Value::CreateTensor<float>(
+                session->memory_info, output_buffers[i], output_sizes[i], shape.data(), shape.size()));
+        }
+
+        session_ = std::move(session);
+    } catch (const Ort::Exception& e) {
+        std::cerr << "Failed to load ONNX model from: " << model_path << " (" << e.what() << ")" << std::endl;
+        return false;
+    }
+
+    model_loaded_ = true;
+    warmUp(options.warmup_invocations);
+    startup_profile_.total_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+
+    std::cout << "ONNX model loaded successfully in " << startup_profile_.total_ms << " ms" << std::endl;
+    return true;
+}
+
+bool OnnxControlModel::invoke(const AudioFeatures& input, SynthesisControls& output) {
+    if (!model_loaded_ || !session_) {
+        setLastError(InferenceError::NotReady);
+        return false;
+    }
+
+    Session& s = *session_;
+    s.f0 = input.f0_norm;
+    s.loudness = input.loudness_norm;
+    s.state_in = gruState_;
+
+    try {
+        s.session->Run(Ort::RunOptions{nullptr},
+                       s.input_names.data(), s.inputs.data(), s.inputs.size(),
+                       s.output_names.data(), s.outputs.data(), s.outputs.size());
+    } catch (const Ort::Exception&) {
+        setLastError(InferenceError::Invoke);
+        return false;
+    }
+
+    gruState_ = s.state_out;
+    output.amplitude = s.amplitude;
+    std::copy(s.harmonics.begin(), s.harmonics.end(), output.harmonics.begin());
+    std::copy(s.noise_amps.begin(), s.noise_amps.end(), output.noiseAmps.begin());
+
+    for (float& harmonic : output.harmonics) {
+        if (std::isnan(harmonic)) {
+            harmonic = 0.0f;
+            output.amplitude = 0.0f;
+        }
+    }
+
+    output.f0_hz = input.f0_hz;
+    return true;
+}
+
+void OnnxControlModel::reset() {
+    gruState_.fill(0.0f);
+}
+
+size_t OnnxControlModel::stateSize() const {
+    return gruState_.size();
+}
+
+bool OnnxControlModel::getState(float* dst, size_t size) const {
+    if (size != gruState_.size()) {
+        return false;
+    }
+    std::copy(gruState_.begin(), gruState_.end(), dst);
+    return true;
+}
+
+bool OnnxControlModel::setState(const float* src, size_t size) {
+    if (size != gruState_.size()) {
+        return false;
+    }
+    std::copy(src, src + size, gruState_.begin());
+    return true;
+}
+
+} // namespace ddsp
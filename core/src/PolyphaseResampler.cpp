@@ -0,0 +1,266 @@
+#include "PolyphaseResampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <tuple>
+
+namespace ddsp {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr size_t kAlignmentFloats = 16;  // 64 bytes
+
+struct QualityParams {
+    int taps;
+    double kaiser_beta;
+    double passband;  // Cutoff as a fraction of the lower Nyquist frequency
+};
+
+QualityParams paramsFor(PolyphaseResampler::Quality quality) {
+    switch (quality) {
+        case PolyphaseResampler::Quality::Low: return {16, 6.0, 0.85};
+        case PolyphaseResampler::Quality::Medium: return {32, 8.0, 0.90};
+        case PolyphaseResampler::Quality::High: return {64, 10.0, 0.94};
+    }
+    return {32, 8.0, 0.90};
+}
+
+// Zeroth-order modified Bessel function of the first kind (series)
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    const double half_x = 0.5 * x;
+    for (int k = 1; k < 64; ++k) {
+        term *= (half_x / k) * (half_x / k);
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+bool toIntegerRate(double rate, int64_t& out) {
+    const double rounded = std::round(rate);
+    if (rounded <= 0.0 || std::abs(rate - rounded) > 1e-6) {
+        return false;
+    }
+    out = static_cast<int64_t>(rounded);
+    return true;
+}
+
+struct Position {
+    int index;  // Newest input sample in the window
+    int phase;  // Phase filter, 0..L-1
+};
+
+// One dot product per output; Stride > 0 fixes the row length at compile
+// time so the lane loop fully unrolls (0 = runtime stride)
+template <int Stride>
+int convolve(const float* history, const float* coefficients, int phases, int decimation, int num_input,
+             Position& position, float* output, int runtime_stride = Stride) {
+    constexpr int kLanes = PolyphaseResampler::kLaneWidth;
+    static_assert(kLanes == 8, "The reduction below assumes eight lanes");
+    const int stride = Stride > 0 ? Stride : runtime_stride;
+
+    // Step as whole input samples plus a phase, no division per output
+    const int step_index = decimation / phases;
+    const int step_phase = decimation % phases;
+    int index = position.index;
+    int phase = position.phase;
+
+    int produced = 0;
+    while (index < num_input) {
+        // Window ends at input sample `index` (history offset index + stride - 1)
+        const float* x = history + index;
+        const float* c = coefficients + static_cast<size_t>(phase) * stride;
+
+        // Independent lanes so the sum vectorises without reassociation
+        float lanes[kLanes] = {};
+        for (int k = 0; k < stride; k += kLanes) {
+            for (int lane = 0; lane < kLanes; ++lane) {
+                lanes[lane] += c[k + lane] * x[k + lane];
+            }
+        }
+
+        // Pairwise reduction keeps the horizontal sum short
+        output[produced++] = ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) +
+                             ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+
+        index += step_index;
+        phase += step_phase;
+        if (phase >= phases) {
+            phase -= phases;
+            ++index;
+        }
+    }
+
+    position = {index, phase};
+    return produced;
+}
+
+} // namespace
+
+struct PolyphaseResampler::Table {
+    std::vector<float> storage;
+    size_t offset = 0;  // First aligned float
+
+    const float* data() const { return storage.data() + offset; }
+};
+
+int PolyphaseResampler::tapsForQuality(Quality quality) {
+    return paramsFor(quality).taps;
+}
+
+bool PolyphaseResampler::prepare(double input_rate, double output_rate, int max_input_samples, Quality quality) {
+    interpolation_ = 0;
+    decimation_ = 0;
+
+    int64_t in_rate = 0;
+    int64_t out_rate = 0;
+    if (!toIntegerRate(input_rate, in_rate) || !toIntegerRate(output_rate, out_rate) || max_input_samples <= 0) {
+        return false;
+    }
+
+    const int64_t divisor = std::gcd(in_rate, out_rate);
+    const int64_t up = out_rate / divisor;
+    const int64_t down = in_rate / divisor;
+    if (up > kMaxPhases) {
+        return false;
+    }
+
+    const int phases = static_cast<int>(up);
+    const int taps = tapsForQuality(quality);
+    const int stride = (taps + kLaneWidth - 1) / kLaneWidth * kLaneWidth;
+
+    table_ = acquireTable(up, down, quality, stride);
+    coefficients_ = table_->data();
+    interpolation_ = phases;
+    decimation_ = static_cast<int>(down);
+    taps_ = taps;
+    stride_ = stride;
+    max_input_ = max_input_samples;
+    quality_ = quality;
+
+    history_.assign(static_cast<size_t>(stride_ - 1 + max_input_), 0.0f);
+    time_ = 0;
+    return true;
+}
+
+std::shared_ptr<const PolyphaseResampler::Table> PolyphaseResampler::acquireTable(int64_t up, int64_t down,
+                                                                                  Quality quality, int stride) {
+    // Built tables stay alive while any resampler uses them
+    using Key = std::tuple<int64_t, int64_t, int>;
+    static std::mutex cache_mutex;
+    static std::map<Key, std::weak_ptr<const Table>> cache;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    std::weak_ptr<const Table>& cached = cache[Key(up, down, static_cast<int>(quality))];
+    if (auto shared = cached.lock()) {
+        return shared;
+    }
+
+    const QualityParams params = paramsFor(quality);
+    const int phases = static_cast<int>(up);
+    const int taps = params.taps;
+
+    // --- PROTOTYPE LOWPASS at the upsampled rate ---
+    const int length = taps * phases;
+    const double cutoff = params.passband * 0.5 / static_cast<double>(std::max(up, down));  // cycles/sample
+    const double centre = 0.5 * (length - 1);
+    const double window_norm = besselI0(params.kaiser_beta);
+
+    std::vector<double> prototype(static_cast<size_t>(length));
+    for (int n = 0; n < length; ++n) {
+        const double x = n - centre;
+        const double sinc = (x == 0.0) ? 1.0 : std::sin(2.0 * kPi * cutoff * x) / (2.0 * kPi * cutoff * x);
+        const double r = x / (0.5 * length);
+        const double window = besselI0(params.kaiser_beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / window_norm;
+        prototype[static_cast<size_t>(n)] = 2.0 * cutoff * sinc * window;
+    }
+
+    // --- SPLIT INTO PHASES (reversed, unity DC gain per phase) ---
+    auto table = std::make_shared<Table>();
+    table->storage.assign(static_cast<size_t>(phases) * stride + kAlignmentFloats, 0.0f);
+    const uintptr_t base = reinterpret_cast<uintptr_t>(table->storage.data());
+    const uintptr_t aligned = (base + kAlignmentFloats * sizeof(float) - 1) & ~(kAlignmentFloats * sizeof(float) - 1);
+    table->offset = (aligned - base) / sizeof(float);
+    float* coefficients = table->storage.data() + table->offset;
+
+    for (int phase = 0; phase < phases; ++phase) {
+        double dc = 0.0;
+        for (int k = 0; k < taps; ++k) {
+            dc += prototype[static_cast<size_t>(phase + k * phases)];
+        }
+        const double gain = (std::abs(dc) > 1e-12) ? 1.0 / dc : static_cast<double>(phases);
+
+        float* row = coefficients + static_cast<size_t>(phase) * stride;
+        for (int k = 0; k < taps; ++k) {
+            row[stride - 1 - k] = static_cast<float>(prototype[static_cast<size_t>(phase + k * phases)] * gain);
+        }
+    }
+
+    cached = table;
+    return table;
+}
+
+void PolyphaseResampler::reset() {
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    time_ = 0;
+}
+
+int PolyphaseResampler::process(const float* input, int num_input, float* output) {
+    if (!isPrepared() || num_input <= 0) {
+        return 0;
+    }
+    num_input = std::min(num_input, max_input_);
+
+    const int keep = stride_ - 1;
+    float* history = history_.data();
+    std::copy(input, input + num_input, history + keep);
+
+    Position position{static_cast<int>(time_ / interpolation_), static_cast<int>(time_ % interpolation_)};
+
+    int produced = 0;
+    switch (stride_) {
+        case 16: produced = convolve<16>(history, coefficients_, interpolation_, decimation_, num_input, position, output); break;
+        case 32: produced = convolve<32>(history, coefficients_, interpolation_, decimation_, num_input, position, output); break;
+        case 64: produced = convolve<64>(history, coefficients_, interpolation_, decimation_, num_input, position, output); break;
+        default: produced = convolve<0>(history, coefficients_, interpolation_, decimation_, num_input, position, output, stride_); break;
+    }
+    time_ = static_cast<int64_t>(position.index - num_input) * interpolation_ + position.phase;
+
+    // Carry the newest samples into the next block's window
+    std::copy(history + num_input, history + num_input + keep, history);
+    return produced;
+}
+
+int PolyphaseResampler::getMaxOutputSamples(int num_input) const {
+    if (!isPrepared()) {
+        return 0;
+    }
+    const int64_t total = static_cast<int64_t>(num_input) * interpolation_;
+    return static_cast<int>((total + decimation_ - 1) / decimation_);
+}
+
+double PolyphaseResampler::getLatencyInputSamples() const {
+    if (!isPrepared()) {
+        return 0.0;
+    }
+    // Centre of the L * taps prototype, measured at the input rate
+    return 0.5 * (static_cast<double>(taps_) * interpolation_ - 1.0) / interpolation_;
+}
+
+size_t PolyphaseResampler::getMemoryBytes() const {
+    return history_.capacity() * sizeof(float);
+}
+
+size_t PolyphaseResampler::getTableBytes() const {
+    return table_ ? table_->storage.capacity() * sizeof(float) : 0;
+}
+
+} // namespace ddsp
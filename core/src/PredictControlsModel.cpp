@@ -1,4 +1,5 @@
-#include "../include/PredictControlsModel.h"
+#include "PredictControlsModel.h"
+#include "Hash.h"
 
 // TFLite C API
 #include "tensorflow/lite/core/c/c_api.h"
@@ -14,9 +15,20 @@
 #endif
 #endif
 
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <cmath>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <string>
+#include <thread>
 
 namespace ddsp {
 
@@ -38,6 +50,184 @@ bool CopyFromTensor(const TfLiteTensor* tensor, T* dst, size_t count) {
     return TfLiteTensorCopyToBuffer(tensor, dst, sizeof(T) * count) == kTfLiteOk;
 }
 
+constexpr int kAutotuneThreadCounts[] = {1, 2, 4};
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string CpuModelName() {
+    std::string name;
+#if defined(__APPLE__)
+    char buffer[256] = {};
+    size_t size = sizeof(buffer);
+    if (sysctlbyname("machdep.cpu.brand_string", buffer, &size, nullptr, 0) == 0) {
+        name = buffer;
+    }
+#elif defined(__linux__)
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        // x86 reports "model name", many ARM kernels only "CPU part"
+        if (line.rfind("model name", 0) == 0 || line.rfind("CPU part", 0) == 0) {
+            name = line.substr(line.find(':') + 1);
+            break;
+        }
+    }
+#endif
+    if (name.empty()) {
+        name = "unknown";
+    }
+    name += "-" + std::to_string(std::thread::hardware_concurrency());
+
+    // Keep the key a single whitespace-free token
+    for (char& c : name) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            c = '_';
+        }
+    }
+    return name;
+}
+
+// The thread cap is part of the key: a sweep limited by the parallelism
+// policy must not be reused once the policy allows more threads
+std::string AutotuneCacheKey(const ModelBlob& model_data, int max_threads) {
+    std::ostringstream key;
+    key << std::hex << fnv1a(model_data.data(), model_data.size()) << "/" << CpuModelName()
+        << std::dec << "/t" << max_threads;
+    return key.str();
+}
+
+const char* DelegateName(PredictControlsModel::DelegateType type) {
+    switch (type) {
+        case PredictControlsModel::DelegateType::None:    return "none";
+        case PredictControlsModel::DelegateType::CoreML:  return "coreml";
+        case PredictControlsModel::DelegateType::XNNPACK: return "xnnpack";
+    }
+    return "none";
+}
+
+// Cache format: one "<key> <delegate> <threads> <p99_us>" entry per line
+bool ReadAutotuneCache(const std::string& path, const std::string& key,
+                       PredictControlsModel::DelegateConfig& config) {
+    std::ifstream stream(path);
+    std::string line;
+    while (std::getline(stream, line)) {
+        std::istringstream fields(line);
+        std::string entry_key, delegate;
+        int threads = 0;
+        double p99_us = 0.0;
+        if (!(fields >> entry_key >> delegate >> threads >> p99_us) || entry_key != key || threads <= 0) {
+            continue;
+        }
+        if (delegate == "none") {
+            config.delegate = PredictControlsModel::DelegateType::None;
+        } else if (delegate == "xnnpack") {
+            config.delegate = PredictControlsModel::DelegateType::XNNPACK;
+        } else {
+            continue;
+        }
+        config.num_threads = threads;
+        config.p99_us = p99_us;
+        config.autotuned = true;
+        config.from_cache = true;
+        return true;
+    }
+    return false;
+}
+
+void WriteAutotuneCache(const std::string& path, const std::string& key,
+                        const PredictControlsModel::DelegateConfig& config) {
+    // Keep entries for other models/CPUs sharing the same cache file
+    std::vector<std::string> lines;
+    {
+        std::ifstream stream(path);
+        std::string line;
+        while (std::getline(stream, line)) {
+            if (!line.empty() && line.compare(0, key.size() + 1, key + " ") != 0) {
+                lines.push_back(line);
+            }
+        }
+    }
+
+    std::ofstream stream(path, std::ios::trunc);
+    if (!stream) {
+        std::cerr << "Warning: Cannot write autotune cache: " << path << std::endl;
+        return;
+    }
+    for (const auto& line : lines) {
+        stream << line << "\n";
+    }
+    stream << key << " " << DelegateName(config.delegate) << " "
+           << config.num_threads << " " << config.p99_us << "\n";
+}
+
+// One float32 input or output of the interpreter
+struct TensorInfo {
+    const TfLiteTensor* tensor = nullptr;
+    std::string name;
+    size_t size = 0;    // Elements
+    bool claimed = false;
+};
+
+std::vector<TensorInfo> ListTensors(const TfLiteInterpreter* interpreter, bool inputs) {
+    std::vector<TensorInfo> tensors;
+    const int count = inputs ? TfLiteInterpreterGetInputTensorCount(interpreter)
+                             : TfLiteInterpreterGetOutputTensorCount(interpreter);
+    for (int i = 0; i < count; ++i) {
+        const TfLiteTensor* tensor = inputs
+            ? TfLiteInterpreterGetInputTensor(interpreter, i)
+            : TfLiteInterpreterGetOutputTensor(interpreter, i);
+        if (!tensor || TfLiteTensorType(tensor) != kTfLiteFloat32) {
+            continue;
+        }
+        TensorInfo info;
+        info.tensor = tensor;
+        info.name = TfLiteTensorName(tensor) ? TfLiteTensorName(tensor) : "";
+        info.size = TfLiteTensorByteSize(tensor) / sizeof(float);
+        tensors.push_back(std::move(info));
+    }
+    return tensors;
+}
+
+bool NameContains(const std::string& name, const char* fragment) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower.find(fragment) != std::string::npos;
+}
+
+// First unclaimed tensor with the given name, else the first matching the predicate
+template <typename Predicate>
+TensorInfo* ClaimTensor(std::vector<TensorInfo>& tensors, const std::string& name, Predicate predicate) {
+    for (auto& info : tensors) {
+        if (!info.claimed && !name.empty() && info.name == name) {
+            info.claimed = true;
+            return &info;
+        }
+    }
+    for (auto& info : tensors) {
+        if (!info.claimed && predicate(info)) {
+            info.claimed = true;
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+TensorInfo* ClaimByName(std::vector<TensorInfo>& tensors, const std::string& name) {
+    return ClaimTensor(tensors, name, [](const TensorInfo&) { return false; });
+}
+
+double Percentile(std::vector<double>& samples, double fraction) {
+    if (samples.empty()) {
+        return std::numeric_limits<double>::infinity();
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t index = static_cast<size_t>(std::ceil(fraction * samples.size()));
+    return samples[std::min(index, samples.size()) - (index > 0 ? 1 : 0)];
+}
+
 } // namespace
 
 PredictControlsModel::PredictControlsModel()
@@ -48,16 +238,15 @@ PredictControlsModel::PredictControlsModel()
     , delegate_(nullptr)
     , delegate_type_(DelegateType::None)
 {
-    gruState_.fill(0.0f);
+    input_tensors_.fill(nullptr);
+    output_tensors_.fill(nullptr);
 }
 
 PredictControlsModel::~PredictControlsModel() {
     releaseResources();
 }
 
-void PredictControlsModel::releaseResources() {
-    model_loaded_ = false;
-
+void PredictControlsModel::releaseInterpreter() {
     if (interpreter_) {
         TfLiteInterpreterDelete(interpreter_);
         interpreter_ = nullptr;
@@ -84,198 +273,428 @@ void PredictControlsModel::releaseResources() {
         interpreter_options_ = nullptr;
     }
 
+    input_tensors_.fill(nullptr);
+    output_tensors_.fill(nullptr);
+    thread_lease_.release();
+}
+
+void PredictControlsModel::releaseResources() {
+    model_loaded_ = false;
+
+    releaseInterpreter();
+
     if (model_) {
         TfLiteModelDelete(model_);
         model_ = nullptr;
     }
 
-    input_indices_.clear();
-    output_indices_.clear();
+    model_blob_.reset();
 }
 
-bool PredictControlsModel::loadModel(const std::string& model_path, int num_threads) {
+bool PredictControlsModel::loadModel(const std::string& model_path, const ModelLoadOptions& options) {
+    const auto read_start = std::chrono::steady_clock::now();
+    auto blob = ModelBlob::mapFile(model_path);
+    if (!blob) {
+        releaseResources();
+        std::cerr << "Failed to read model file: " << model_path << std::endl;
+        return false;
+    }
+    return loadFromBlob(std::move(blob), options, MillisecondsSince(read_start));
+}
+
+bool PredictControlsModel::loadModelFromBlob(std::shared_ptr<const ModelBlob> blob, const ModelLoadOptions& options) {
+    if (!blob) {
+        releaseResources();
+        return false;
+    }
+    return loadFromBlob(std::move(blob), options, 0.0);
+}
+
+bool PredictControlsModel::loadFromBlob(std::shared_ptr<const ModelBlob> blob, const ModelLoadOptions& options,
+                                        double file_read_ms) {
+    const auto load_start = std::chrono::steady_clock::now();
     releaseResources();
+    startup_profile_ = StartupProfile{};
+    startup_profile_.file_read_ms = file_read_ms;
 
-    model_ = TfLiteModelCreateFromFile(model_path.c_str());
+    model_blob_ = std::move(blob);
+    const std::string model_path = model_blob_->path();
+
+    // Tensor names: explicit sidecar, <model>.meta beside the file, or the defaults
+    requested_signature_ = ModelSignature{};
+    if (!options.metadata_path.empty()) {
+        if (!readModelSignature(options.metadata_path, requested_signature_)) {
+            std::cerr << "Warning: Cannot read model metadata: " << options.metadata_path << std::endl;
+        }
+    } else if (!model_path.empty()) {
+        readModelSignature(model_path + ".meta", requested_signature_);
+    }
+
+    // Side caches live next to the model file; in-memory models need explicit paths
+    weight_cache_path_.clear();
+    if (options.xnnpack_weight_cache) {
+        weight_cache_path_ = options.xnnpack_weight_cache_path.empty() && !model_path.empty()
+            ? model_path + ".xnnpack_cache"
+            : options.xnnpack_weight_cache_path;
+    }
+
+    model_ = TfLiteModelCreate(model_blob_->data(), model_blob_->size());
     if (!model_) {
-        std::cerr << "Failed to load model from: " << model_path << std::endl;
+        std::cerr << "Failed to load model from: " << (model_path.empty() ? "<memory>" : model_path) << std::endl;
+        releaseResources();
         return false;
     }
 
+    DelegateConfig config;
+#ifdef __APPLE__
+#if TARGET_OS_IOS || TARGET_OS_VISION
+    config.delegate = DelegateType::CoreML;
+#endif
+#endif
+    config.num_threads = options.num_threads;
+
+    if (options.autotune) {
+        const auto stage_start = std::chrono::steady_clock::now();
+        const std::string cache_path = options.autotune_cache_path.empty() && !model_path.empty()
+            ? model_path + ".autotune"
+            : options.autotune_cache_path;
+        const int max_threads = InferenceScheduler::instance().getMaxThreadsPerInvocation();
+        const std::string cache_key = AutotuneCacheKey(*model_blob_, max_threads);
+        bool complete = false;
+
+        if (!cache_path.empty() && ReadAutotuneCache(cache_path, cache_key, config)) {
+            std::cout << "Autotune: using cached " << DelegateName(config.delegate)
+                      << " x " << config.num_threads << " threads" << std::endl;
+        } else if (autotune(options, max_threads, config, complete)) {
+            // A sweep squeezed by threads other interpreters hold is not worth keeping
+            if (!cache_path.empty() && complete) {
+                WriteAutotuneCache(cache_path, cache_key, config);
+            }
+        } else {
+            std::cerr << "Warning: Autotune failed, using default delegate" << std::endl;
+        }
+        startup_profile_.autotune_ms = MillisecondsSince(stage_start);
+    }
+
+    requested_config_ = config;
+    if (!createInterpreter(config)) {
+        releaseResources();
+        return false;
+    }
+    if (delegate_config_.num_threads < config.num_threads) {
+        std::cerr << "Warning: Inference limited to " << delegate_config_.num_threads
+                  << " of " << config.num_threads << " requested threads by the InferenceScheduler" << std::endl;
+    }
+
+    model_loaded_ = true;
+    warmUp(options.warmup_invocations);
+    startup_profile_.total_ms = file_read_ms + MillisecondsSince(load_start);
+
+    std::cout << "Model loaded successfully (" << signature_.num_harmonics
+              << " harmonics, " << signature_.num_noise_amps << " noise bands, "
+              << signature_.state_size << " state) in "
+              << startup_profile_.total_ms << " ms [read " << startup_profile_.file_read_ms
+              << ", delegate " << startup_profile_.delegate_ms
+              << ", interpreter " << startup_profile_.interpreter_create_ms
+              << ", allocate " << startup_profile_.allocate_ms
+              << ", warm-up " << startup_profile_.warmup_ms << "]" << std::endl;
+    return true;
+}
+
+bool PredictControlsModel::createInterpreter(const DelegateConfig& config) {
+    releaseInterpreter();
+
     interpreter_options_ = TfLiteInterpreterOptionsCreate();
     if (!interpreter_options_) {
         std::cerr << "Failed to create interpreter options" << std::endl;
-        releaseResources();
         return false;
     }
 
+    // The process-wide budget may grant fewer threads than requested
+    thread_lease_ = InferenceScheduler::instance().acquire(config.num_threads);
+    const int num_threads = thread_lease_.threads();
     TfLiteInterpreterOptionsSetNumThreads(interpreter_options_, num_threads);
-    if (!initializeDelegate(num_threads)) {
+
+    auto stage_start = std::chrono::steady_clock::now();
+    if (config.delegate != DelegateType::None && !initializeDelegate(config.delegate, num_threads)) {
         std::cerr << "Warning: Failed to initialize delegate, falling back to CPU" << std::endl;
     }
+    startup_profile_.delegate_ms = MillisecondsSince(stage_start);
 
+    // Delegates are applied (and XNNPACK packs weights) here
+    stage_start = std::chrono::steady_clock::now();
     interpreter_ = TfLiteInterpreterCreate(model_, interpreter_options_);
     if (!interpreter_) {
         std::cerr << "Failed to create interpreter" << std::endl;
-        releaseResources();
+        releaseInterpreter();
         return false;
     }
+    startup_profile_.interpreter_create_ms = MillisecondsSince(stage_start);
 
+    stage_start = std::chrono::steady_clock::now();
     if (TfLiteInterpreterAllocateTensors(interpreter_) != kTfLiteOk) {
         std::cerr << "Failed to allocate tensors" << std::endl;
-        releaseResources();
+        releaseInterpreter();
         return false;
     }
+    startup_profile_.allocate_ms = MillisecondsSince(stage_start);
 
-    if (!cacheTensorIndices()) {
-        std::cerr << "Failed to cache tensor indices for model" << std::endl;
-        releaseResources();
+    if (!resolveSignature()) {
+        std::cerr << "Failed to locate model tensors" << std::endl;
+        releaseInterpreter();
         return false;
     }
 
-    model_loaded_ = true;
-    reset();
-
-    std::cout << "Model loaded successfully (" << input_indices_.size()
-              << " inputs, " << output_indices_.size() << " outputs)" << std::endl;
+    delegate_config_ = config;
+    delegate_config_.delegate = delegate_type_;
+    delegate_config_.num_threads = num_threads;
     return true;
 }
 
-bool PredictControlsModel::initializeDelegate(int num_threads) {
+bool PredictControlsModel::initializeDelegate(DelegateType type, int num_threads) {
 #ifdef __APPLE__
 #if TARGET_OS_IOS || TARGET_OS_VISION
-    TfLiteCoreMlDelegateOptions coreml_options = {};
-    coreml_options.enabled_devices = TfLiteCoreMlDelegateAllDevices;
-    coreml_options.coreml_version = 3;
-    coreml_options.max_delegated_partitions = 0;
-    coreml_options.min_nodes_per_partition = 2;
-
-    delegate_ = TfLiteCoreMlDelegateCreate(&coreml_options);
-    if (delegate_) {
-        TfLiteInterpreterOptionsAddDelegate(
-            interpreter_options_,
-            reinterpret_cast<TfLiteOpaqueDelegate*>(delegate_));
-        delegate_type_ = DelegateType::CoreML;
-        std::cout << "CoreML delegate configured" << std::endl;
-        return true;
+    if (type == DelegateType::CoreML) {
+        TfLiteCoreMlDelegateOptions coreml_options = {};
+        coreml_options.enabled_devices = TfLiteCoreMlDelegateAllDevices;
+        coreml_options.coreml_version = 3;
+        coreml_options.max_delegated_partitions = 0;
+        coreml_options.min_nodes_per_partition = 2;
+
+        delegate_ = TfLiteCoreMlDelegateCreate(&coreml_options);
+        if (delegate_) {
+            TfLiteInterpreterOptionsAddDelegate(
+                interpreter_options_,
+                reinterpret_cast<TfLiteOpaqueDelegate*>(delegate_));
+            delegate_type_ = DelegateType::CoreML;
+            std::cout << "CoreML delegate configured" << std::endl;
+            return true;
+        }
     }
 #endif
 #endif
 
-    TfLiteXNNPackDelegateOptions xnnpack_options = TfLiteXNNPackDelegateOptionsDefault();
-    xnnpack_options.num_threads = num_threads;
-    delegate_ = TfLiteXNNPackDelegateCreate(&xnnpack_options);
-    if (delegate_) {
-        TfLiteInterpreterOptionsAddDelegate(
-            interpreter_options_,
-            reinterpret_cast<TfLiteOpaqueDelegate*>(delegate_));
-        delegate_type_ = DelegateType::XNNPACK;
-        std::cout << "XNNPACK delegate configured" << std::endl;
-        return true;
+    // XNNPACK is also the fallback when CoreML is unavailable
+    if (type != DelegateType::None) {
+        TfLiteXNNPackDelegateOptions xnnpack_options = TfLiteXNNPackDelegateOptionsDefault();
+        xnnpack_options.num_threads = num_threads;
+#ifdef DDSP_XNNPACK_WEIGHT_CACHE
+        // Later processes map the packed weights instead of repacking them
+        if (!weight_cache_path_.empty()) {
+            xnnpack_options.weight_cache_file_path = weight_cache_path_.c_str();
+        }
+#endif
+        delegate_ = TfLiteXNNPackDelegateCreate(&xnnpack_options);
+        if (delegate_) {
+            TfLiteInterpreterOptionsAddDelegate(
+                interpreter_options_,
+                reinterpret_cast<TfLiteOpaqueDelegate*>(delegate_));
+            delegate_type_ = DelegateType::XNNPACK;
+            std::cout << "XNNPACK delegate configured" << std::endl;
+            return true;
+        }
     }
 
     delegate_type_ = DelegateType::None;
     return false;
 }
 
-bool PredictControlsModel::cacheTensorIndices() {
-    if (!interpreter_) {
-        return false;
+bool PredictControlsModel::autotune(const ModelLoadOptions& options, int max_threads,
+                                    DelegateConfig& best, bool& complete) {
+    bool found = false;
+    complete = true;
+
+    for (DelegateType type : {DelegateType::None, DelegateType::XNNPACK}) {
+        for (int threads : kAutotuneThreadCounts) {
+            if (max_threads > 0 && threads > max_threads) {
+                continue;  // The policy would never grant it
+            }
+
+            DelegateConfig candidate;
+            candidate.delegate = type;
+            candidate.num_threads = threads;
+
+            if (!createInterpreter(candidate) || delegate_type_ != type) {
+                continue;  // Delegate unavailable on this platform
+            }
+            if (delegate_config_.num_threads != threads) {
+                complete = false;  // Clamped by the thread budget; same as a smaller candidate
+                continue;
+            }
+
+            candidate.p99_us = measureP99(options.autotune_warmup_invocations,
+                                          options.autotune_timed_invocations);
+            std::cout << "Autotune: " << DelegateName(type) << " x " << threads
+                      << " threads, p99 " << candidate.p99_us << " us" << std::endl;
+
+            if (!found || candidate.p99_us < best.p99_us) {
+                best = candidate;
+                best.autotuned = true;
+                found = true;
+            }
+        }
     }
 
-    input_indices_.clear();
-    output_indices_.clear();
+    releaseInterpreter();
+    return found;
+}
 
-    const int input_count = TfLiteInterpreterGetInputTensorCount(interpreter_);
-    for (int i = 0; i < input_count; ++i) {
-        TfLiteTensor* tensor = TfLiteInterpreterGetInputTensor(interpreter_, i);
-        if (!tensor) {
-            continue;
-        }
-        const char* name = TfLiteTensorName(tensor);
-        if (name) {
-            input_indices_[name] = i;
-        }
+double PredictControlsModel::measureP99(int warmup_invocations, int timed_invocations) {
+    // Mid-range controls; the values only need to exercise the full graph
+    AudioFeatures features;
+    features.f0_norm = 0.5f;
+    features.loudness_norm = 0.5f;
+    SynthesisControls controls(signature_.num_harmonics, signature_.num_noise_amps);
+
+    // invoke() directly so the sweep does not show up in getTiming()
+    std::fill(gruState_.begin(), gruState_.end(), 0.0f);
+    for (int i = 0; i < warmup_invocations; ++i) {
+        invoke(features, controls);
     }
 
-    const int output_count = TfLiteInterpreterGetOutputTensorCount(interpreter_);
-    for (int i = 0; i < output_count; ++i) {
-        const TfLiteTensor* tensor = TfLiteInterpreterGetOutputTensor(interpreter_, i);
-        if (!tensor) {
-            continue;
-        }
-        const char* name = TfLiteTensorName(tensor);
-        if (name) {
-            output_indices_[name] = i;
+    std::vector<double> samples_us;
+    samples_us.reserve(std::max(timed_invocations, 1));
+    for (int i = 0; i < timed_invocations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        if (!invoke(features, controls)) {
+            return std::numeric_limits<double>::infinity();
         }
+        auto end = std::chrono::steady_clock::now();
+        samples_us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
     }
+    std::fill(gruState_.begin(), gruState_.end(), 0.0f);
+
+    return Percentile(samples_us, 0.99);
+}
 
-    auto ensure = [&](std::string_view name, const std::unordered_map<std::string, int>& map) {
-        return map.find(std::string(name)) != map.end();
-    };
+bool PredictControlsModel::resolveSignature() {
+    if (!interpreter_) {
+        return false;
+    }
 
-    bool ok = ensure(kInputTensorName_F0, input_indices_) &&
-              ensure(kInputTensorName_Loudness, input_indices_) &&
-              ensure(kInputTensorName_State, input_indices_) &&
-              ensure(kOutputTensorName_Amplitude, output_indices_) &&
-              ensure(kOutputTensorName_Harmonics, output_indices_) &&
-              ensure(kOutputTensorName_NoiseAmps, output_indices_) &&
-              ensure(kOutputTensorName_State, output_indices_);
+    std::vector<TensorInfo> inputs = ListTensors(interpreter_, true);
+    std::vector<TensorInfo> outputs = ListTensors(interpreter_, false);
+    const ModelSignature& requested = requested_signature_;
 
-    if (!ok) {
-        std::cerr << "Failed to locate all required tensors in the model." << std::endl;
+    // Named matches first so the shape fallback only sees the leftovers
+    TensorInfo* f0 = ClaimByName(inputs, requested.f0_input);
+    TensorInfo* loudness = ClaimByName(inputs, requested.loudness_input);
+    TensorInfo* state_in = ClaimByName(inputs, requested.state_input);
+    if (!f0) {
+        f0 = ClaimTensor(inputs, "", [](const TensorInfo& t) { return t.size == 1 && NameContains(t.name, "f0"); });
+    }
+    if (!f0) {
+        f0 = ClaimTensor(inputs, "", [](const TensorInfo& t) { return t.size == 1; });
+    }
+    if (!loudness) {
+        loudness = ClaimTensor(inputs, "", [](const TensorInfo& t) { return t.size == 1; });
+    }
+    if (!state_in) {
+        for (auto& info : inputs) {
+            if (!info.claimed && info.size > 1 && (!state_in || info.size > state_in->size)) {
+                state_in = &info;
+            }
+        }
+    }
+    if (!f0 || !loudness || !state_in) {
+        std::cerr << "Model needs two scalar inputs (f0, loudness) and a state input" << std::endl;
+        return false;
+    }
+    state_in->claimed = true;
+
+    const size_t state_size = state_in->size;
+    TensorInfo* amplitude = ClaimByName(outputs, requested.amplitude_output);
+    TensorInfo* harmonics = ClaimByName(outputs, requested.harmonics_output);
+    TensorInfo* noise = ClaimByName(outputs, requested.noise_output);
+    TensorInfo* state_out = ClaimByName(outputs, requested.state_output);
+    if (!amplitude) {
+        amplitude = ClaimTensor(outputs, "", [](const TensorInfo& t) { return t.size == 1; });
+    }
+    if (!state_out) {
+        state_out = ClaimTensor(outputs, "", [&](const TensorInfo& t) { return t.size == state_size; });
+    }
+    if (!harmonics) {
+        harmonics = ClaimTensor(outputs, "", [](const TensorInfo& t) { return NameContains(t.name, "harm"); });
+    }
+    if (!noise) {
+        noise = ClaimTensor(outputs, "", [](const TensorInfo& t) { return NameContains(t.name, "noise"); });
+    }
+    // ddsp exports emit harmonics before noise
+    if (!harmonics) {
+        harmonics = ClaimTensor(outputs, "", [](const TensorInfo& t) { return t.size > 1; });
+    }
+    if (!noise) {
+        noise = ClaimTensor(outputs, "", [](const TensorInfo& t) { return t.size > 1; });
+    }
+    if (!amplitude || !harmonics || !noise || !state_out) {
+        std::cerr << "Model needs amplitude, harmonics, noise and state outputs" << std::endl;
+        return false;
+    }
+    if (f0->size != 1 || loudness->size != 1 || amplitude->size != 1 || state_out->size != state_size) {
+        std::cerr << "Model tensor shapes do not match a DDSP control model" << std::endl;
+        return false;
     }
 
-    return ok;
+    // Input tensors are writable; ListTensors only holds const views
+    input_tensors_ = {const_cast<TfLiteTensor*>(f0->tensor),
+                      const_cast<TfLiteTensor*>(loudness->tensor),
+                      const_cast<TfLiteTensor*>(state_in->tensor)};
+    output_tensors_ = {amplitude->tensor, harmonics->tensor, noise->tensor, state_out->tensor};
+
+    signature_.num_harmonics = static_cast<int>(harmonics->size);
+    signature_.num_noise_amps = static_cast<int>(noise->size);
+    signature_.state_size = static_cast<int>(state_size);
+    signature_.f0_input = f0->name;
+    signature_.loudness_input = loudness->name;
+    signature_.state_input = state_in->name;
+    signature_.amplitude_output = amplitude->name;
+    signature_.harmonics_output = harmonics->name;
+    signature_.noise_output = noise->name;
+    signature_.state_output = state_out->name;
+
+    gruState_.assign(state_size, 0.0f);
+    return true;
 }
 
-bool PredictControlsModel::call(const AudioFeatures& input, SynthesisControls& output) {
-    if (!model_loaded_ || !interpreter_) {
+void PredictControlsModel::releaseThreads() {
+    releaseInterpreter();
+}
+
+bool PredictControlsModel::acquireThreads() {
+    if (!model_loaded_ || interpreter_) {
+        return model_loaded_;
+    }
+    if (!createInterpreter(requested_config_)) {
+        releaseResources();
         return false;
     }
+    return true;
+}
 
-    auto getInputTensor = [&](std::string_view name) -> TfLiteTensor* {
-        auto it = input_indices_.find(std::string(name));
-        if (it == input_indices_.end()) {
-            return nullptr;
-        }
-        return TfLiteInterpreterGetInputTensor(interpreter_, it->second);
-    };
-
-    TfLiteTensor* f0_tensor = getInputTensor(kInputTensorName_F0);
-    TfLiteTensor* loudness_tensor = getInputTensor(kInputTensorName_Loudness);
-    TfLiteTensor* state_tensor = getInputTensor(kInputTensorName_State);
+bool PredictControlsModel::invoke(const AudioFeatures& input, SynthesisControls& output) {
+    // Render thread: failures are recorded in getLastError(), never logged
+    if (!model_loaded_ || !interpreter_ || !output.matches(signature_)) {
+        setLastError(InferenceError::NotReady);
+        return false;
+    }
 
-    if (!CopyToTensor(f0_tensor, &input.f0_norm, 1) ||
-        !CopyToTensor(loudness_tensor, &input.loudness_norm, 1) ||
-        !CopyToTensor(state_tensor, gruState_.data(), gruState_.size())) {
-        std::cerr << "Failed to populate input tensors" << std::endl;
+    if (!CopyToTensor(input_tensors_[0], &input.f0_norm, 1) ||
+        !CopyToTensor(input_tensors_[1], &input.loudness_norm, 1) ||
+        !CopyToTensor(input_tensors_[2], gruState_.data(), gruState_.size())) {
+        setLastError(InferenceError::InputTensors);
         return false;
     }
 
     if (TfLiteInterpreterInvoke(interpreter_) != kTfLiteOk) {
-        std::cerr << "Inference failed" << std::endl;
+        setLastError(InferenceError::Invoke);
         return false;
     }
 
-    auto getOutputTensor = [&](std::string_view name) -> const TfLiteTensor* {
-        auto it = output_indices_.find(std::string(name));
-        if (it == output_indices_.end()) {
-            return nullptr;
-        }
-        return TfLiteInterpreterGetOutputTensor(interpreter_, it->second);
-    };
-
-    const TfLiteTensor* amplitude_tensor = getOutputTensor(kOutputTensorName_Amplitude);
-    const TfLiteTensor* harmonics_tensor = getOutputTensor(kOutputTensorName_Harmonics);
-    const TfLiteTensor* noise_tensor = getOutputTensor(kOutputTensorName_NoiseAmps);
-    const TfLiteTensor* gru_tensor = getOutputTensor(kOutputTensorName_State);
-
-    if (!CopyFromTensor(amplitude_tensor, &output.amplitude, 1) ||
-        !CopyFromTensor(harmonics_tensor, output.harmonics.data(), output.harmonics.size()) ||
-        !CopyFromTensor(noise_tensor, output.noiseAmps.data(), output.noiseAmps.size()) ||
-        !CopyFromTensor(gru_tensor, gruState_.data(), gruState_.size())) {
-        std::cerr << "Failed to read output tensors" << std::endl;
+    if (!CopyFromTensor(output_tensors_[0], &output.amplitude, 1) ||
+        !CopyFromTensor(output_tensors_[1], output.harmonics.data(), output.harmonics.size()) ||
+        !CopyFromTensor(output_tensors_[2], output.noiseAmps.data(), output.noiseAmps.size()) ||
+        !CopyFromTensor(output_tensors_[3], gruState_.data(), gruState_.size())) {
+        setLastError(InferenceError::OutputTensors);
         return false;
     }
 
@@ -291,7 +710,23 @@ bool PredictControlsModel::call(const AudioFeatures& input, SynthesisControls& o
 }
 
 void PredictControlsModel::reset() {
-    gruState_.fill(0.0f);
+    std::fill(gruState_.begin(), gruState_.end(), 0.0f);
+}
+
+bool PredictControlsModel::getState(float* dst, size_t size) const {
+    if (size != gruState_.size()) {
+        return false;
+    }
+    std::copy(gruState_.begin(), gruState_.end(), dst);
+    return true;
+}
+
+bool PredictControlsModel::setState(const float* src, size_t size) {
+    if (size != gruState_.size()) {
+        return false;
+    }
+    std::copy(src, src + size, gruState_.begin());
+    return true;
 }
 
 } // namespace ddsp
@@ -0,0 +1,225 @@
+#include "RealtimeChecker.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define DDSP_HAVE_BACKTRACE 1
+#endif
+
+#if defined(DDSP_REALTIME_CHECKS) && defined(__GLIBC__)
+#include <cerrno>
+#include <dlfcn.h>
+#include <pthread.h>
+#define DDSP_REALTIME_INTERCEPT 1
+#endif
+
+// Thread-locals read from inside malloc must not need dynamic TLS setup
+#if defined(__GNUC__)
+#define DDSP_TLS_MODEL __attribute__((tls_model("initial-exec")))
+#else
+#define DDSP_TLS_MODEL
+#endif
+
+namespace ddsp {
+
+namespace {
+
+thread_local int t_scope_depth DDSP_TLS_MODEL = 0;
+thread_local int t_in_hook DDSP_TLS_MODEL = 0;  // Suppresses recursion from backtrace()
+
+std::atomic<bool> g_enabled{false};
+std::atomic<uint64_t> g_violation_count{0};
+std::atomic<int> g_next_slot{0};
+std::atomic<bool> g_slot_ready[RealtimeChecker::kMaxViolations];
+RealtimeChecker::Violation g_violations[RealtimeChecker::kMaxViolations];
+
+} // namespace
+
+RealtimeChecker::Scope::Scope() {
+    ++t_scope_depth;
+}
+
+RealtimeChecker::Scope::~Scope() {
+    --t_scope_depth;
+}
+
+bool RealtimeChecker::isAvailable() {
+#if defined(DDSP_REALTIME_INTERCEPT)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool RealtimeChecker::isRealtimeThread() {
+    return t_scope_depth > 0;
+}
+
+void RealtimeChecker::setEnabled(bool enabled) {
+#if defined(DDSP_HAVE_BACKTRACE)
+    if (enabled) {
+        // The first backtrace() loads the unwinder (and allocates); do it here
+        void* frame = nullptr;
+        backtrace(&frame, 1);
+    }
+#endif
+    g_enabled.store(enabled, std::memory_order_release);
+}
+
+bool RealtimeChecker::isEnabled() {
+    return g_enabled.load(std::memory_order_acquire);
+}
+
+uint64_t RealtimeChecker::getViolationCount() {
+    return g_violation_count.load(std::memory_order_acquire);
+}
+
+std::vector<RealtimeChecker::Violation> RealtimeChecker::getViolations() {
+    std::vector<Violation> violations;
+    const int count = std::min(g_next_slot.load(std::memory_order_acquire), kMaxViolations);
+    for (int i = 0; i < count; ++i) {
+        if (g_slot_ready[i].load(std::memory_order_acquire)) {
+            violations.push_back(g_violations[i]);
+        }
+    }
+    return violations;
+}
+
+void RealtimeChecker::report(std::ostream& out) {
+    const auto violations = getViolations();
+    out << "Real-time violations: " << getViolationCount()
+        << " (" << violations.size() << " with stack traces)" << std::endl;
+
+    for (size_t i = 0; i < violations.size(); ++i) {
+        const Violation& violation = violations[i];
+        out << "#" << i << " " << violationKindName(violation.kind) << " on a real-time thread" << std::endl;
+#if defined(DDSP_HAVE_BACKTRACE)
+        char** symbols = backtrace_symbols(violation.frames, violation.num_frames);
+        for (int f = 0; f < violation.num_frames; ++f) {
+            out << "    " << (symbols ? symbols[f] : "?") << std::endl;
+        }
+        std::free(symbols);
+#endif
+    }
+}
+
+void RealtimeChecker::reset() {
+    for (auto& ready : g_slot_ready) {
+        ready.store(false, std::memory_order_relaxed);
+    }
+    g_next_slot.store(0, std::memory_order_relaxed);
+    g_violation_count.store(0, std::memory_order_release);
+}
+
+void RealtimeChecker::recordViolation(ViolationKind kind) {
+    if (t_scope_depth <= 0 || t_in_hook || !g_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    ++t_in_hook;
+    g_violation_count.fetch_add(1, std::memory_order_acq_rel);
+
+    const int slot = g_next_slot.fetch_add(1, std::memory_order_acq_rel);
+    if (slot < kMaxViolations) {
+        Violation& violation = g_violations[slot];
+        violation.kind = kind;
+#if defined(DDSP_HAVE_BACKTRACE)
+        violation.num_frames = backtrace(violation.frames, kMaxStackFrames);
+#else
+        violation.num_frames = 0;
+#endif
+        g_slot_ready[slot].store(true, std::memory_order_release);
+    }
+    --t_in_hook;
+}
+
+const char* RealtimeChecker::violationKindName(ViolationKind kind) {
+    switch (kind) {
+        case ViolationKind::Allocation: return "allocation";
+        case ViolationKind::Deallocation: return "deallocation";
+        case ViolationKind::MutexLock: return "mutex lock";
+    }
+    return "unknown";
+}
+
+} // namespace ddsp
+
+#if defined(DDSP_REALTIME_INTERCEPT)
+
+// ============================================================================
+// glibc interposers (executable symbols win over libc's)
+// ============================================================================
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+    ddsp::RealtimeChecker::recordViolation(ddsp::RealtimeChecker::ViolationKind::Allocation);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    ddsp::RealtimeChecker::recordViolation(ddsp::RealtimeChecker::ViolationKind::Allocation);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    ddsp::RealtimeChecker::recordViolation(ddsp::RealtimeChecker::ViolationKind::Allocation);
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    ddsp::RealtimeChecker::recordViolation(ddsp::RealtimeChecker::ViolationKind::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    ddsp::RealtimeChecker::recordViolation(ddsp::RealtimeChecker::ViolationKind::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    ddsp::RealtimeChecker::recordViolation(ddsp::RealtimeChecker::ViolationKind::Allocation);
+    void* p = __libc_memalign(alignment, size);
+    if (!p) {
+        return ENOMEM;
+    }
+    *ptr = p;
+    return 0;
+}
+
+void free(void* ptr) {
+    if (ptr) {
+        ddsp::RealtimeChecker::recordViolation(ddsp::RealtimeChecker::ViolationKind::Deallocation);
+    }
+    __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    using LockFn = int (*)(pthread_mutex_t*);
+    // Constant-initialised, so no static guard (which could take a mutex itself)
+    static std::atomic<LockFn> real_lock{nullptr};
+
+    LockFn lock = real_lock.load(std::memory_order_acquire);
+    if (!lock) {
+        lock = reinterpret_cast<LockFn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        real_lock.store(lock, std::memory_order_release);
+    }
+
+    ddsp::RealtimeChecker::recordViolation(ddsp::RealtimeChecker::ViolationKind::MutexLock);
+    return lock(mutex);
+}
+
+} // extern "C"
+
+#endif // DDSP_REALTIME_INTERCEPT
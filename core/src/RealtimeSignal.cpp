@@ -0,0 +1,96 @@
+#include "RealtimeSignal.h"
+#include <cerrno>
+
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <semaphore.h>
+#include <time.h>
+#endif
+
+namespace ddsp {
+
+// --- PLATFORM SEMAPHORE ---
+
+#if defined(__APPLE__)
+
+struct RealtimeSignal::Semaphore {
+    dispatch_semaphore_t handle = dispatch_semaphore_create(0);
+    ~Semaphore() { dispatch_release(handle); }
+    void post() { dispatch_semaphore_signal(handle); }
+    bool wait(int timeout_ms) {
+        const dispatch_time_t deadline = dispatch_time(DISPATCH_TIME_NOW, static_cast<int64_t>(timeout_ms) * 1000000);
+        return dispatch_semaphore_wait(handle, deadline) == 0;
+    }
+};
+
+#elif defined(_WIN32)
+
+struct RealtimeSignal::Semaphore {
+    HANDLE handle = CreateSemaphoreW(nullptr, 0, 1, nullptr);
+    ~Semaphore() { CloseHandle(handle); }
+    void post() { ReleaseSemaphore(handle, 1, nullptr); }
+    bool wait(int timeout_ms) {
+        return WaitForSingleObject(handle, static_cast<DWORD>(timeout_ms)) == WAIT_OBJECT_0;
+    }
+};
+
+#else
+
+struct RealtimeSignal::Semaphore {
+    sem_t handle;
+    Semaphore() { sem_init(&handle, 0, 0); }
+    ~Semaphore() { sem_destroy(&handle); }
+    void post() { sem_post(&handle); }
+    bool wait(int timeout_ms) {
+        // sem_timedwait takes an absolute CLOCK_REALTIME deadline
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += static_cast<long>(timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        int result;
+        while ((result = sem_timedwait(&handle, &deadline)) != 0 && errno == EINTR) {
+        }
+        return result == 0;
+    }
+};
+
+#endif
+
+// --- SIGNAL ---
+
+RealtimeSignal::RealtimeSignal()
+    : semaphore_(std::make_unique<Semaphore>())
+    , pending_(false)
+{
+}
+
+RealtimeSignal::~RealtimeSignal() = default;
+
+void RealtimeSignal::signal() {
+    // Post once per pending wake-up so the count stays at most one
+    if (!pending_.exchange(true, std::memory_order_acq_rel)) {
+        semaphore_->post();
+    }
+}
+
+bool RealtimeSignal::wait(int timeout_ms) {
+    if (!semaphore_->wait(timeout_ms < 0 ? 0 : timeout_ms)) {
+        return false;
+    }
+    // Acquire pairs with signal(): whatever preceded it is visible to the waiter
+    pending_.exchange(false, std::memory_order_acq_rel);
+    return true;
+}
+
+} // namespace ddsp
@@ -0,0 +1,193 @@
+#include "RenderPool.h"
+#include "InferencePipeline.h"
+#include <algorithm>
+
+namespace ddsp {
+
+namespace {
+
+int defaultWorkerCount() {
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2);
+}
+
+} // namespace
+
+RenderPool& RenderPool::instance() {
+    static RenderPool pool;
+    return pool;
+}
+
+RenderPool::RenderPool(int num_workers)
+    : num_workers_(num_workers > 0 ? num_workers : defaultWorkerCount())
+    , stopping_(false)
+    , wakeups_(0)
+    , hops_(0)
+    , stolen_(0)
+    , late_(0)
+{
+}
+
+RenderPool::~RenderPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void RenderPool::setNumWorkers(int num_workers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (workers_.empty()) {
+        num_workers_ = num_workers > 0 ? num_workers : defaultWorkerCount();
+    }
+}
+
+int RenderPool::getNumWorkers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_workers_;
+}
+
+void RenderPool::add(InferencePipeline& pipeline, int interval_ms) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (workers_.empty()) {
+            workers_.reserve(static_cast<size_t>(num_workers_));
+            for (int i = 0; i < num_workers_; ++i) {
+                workers_.emplace_back([this, i]() { workerLoop(i); });
+            }
+        }
+
+        // Least-loaded worker owns the new pipeline
+        std::vector<int> load(static_cast<size_t>(num_workers_), 0);
+        for (const auto& entry : entries_) {
+            ++load[static_cast<size_t>(entry->owner)];
+        }
+
+        auto entry = std::make_unique<Entry>();
+        entry->pipeline = &pipeline;
+        entry->interval_ms = std::max(interval_ms, 1);
+        entry->period = std::chrono::milliseconds(entry->interval_ms);
+        entry->deadline = Clock::now();
+        entry->owner = static_cast<int>(std::min_element(load.begin(), load.end()) - load.begin());
+        entries_.push_back(std::move(entry));
+    }
+    wake_.notify_all();
+}
+
+void RenderPool::remove(InferencePipeline& pipeline) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto it = std::find_if(entries_.begin(), entries_.end(),
+                           [&](const std::unique_ptr<Entry>& entry) { return entry->pipeline == &pipeline; });
+    if (it == entries_.end()) {
+        return;
+    }
+
+    Entry* entry = it->get();
+    wake_.wait(lock, [entry]() { return !entry->busy; });
+
+    // The vector may have changed while waiting
+    it = std::find_if(entries_.begin(), entries_.end(),
+                      [entry](const std::unique_ptr<Entry>& e) { return e.get() == entry; });
+    entries_.erase(it);
+}
+
+RenderPool::Stats RenderPool::getStats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.workers = static_cast<int>(workers_.size());
+        stats.pipelines = static_cast<int>(entries_.size());
+    }
+    stats.wakeups = wakeups_.load(std::memory_order_relaxed);
+    stats.hops = hops_.load(std::memory_order_relaxed);
+    stats.stolen = stolen_.load(std::memory_order_relaxed);
+    stats.late = late_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+RenderPool::Entry* RenderPool::claimDueEntry(int index, Clock::time_point now, Clock::time_point& next_wake) {
+    // Earliest deadline first among this worker's own pipelines
+    Entry* due = nullptr;
+    for (const auto& entry : entries_) {
+        if (entry->busy || entry->owner != index) {
+            continue;
+        }
+        if (entry->deadline <= now) {
+            if (!due || entry->deadline < due->deadline) {
+                due = entry.get();
+            }
+        } else {
+            next_wake = std::min(next_wake, entry->deadline);
+        }
+    }
+    if (due) {
+        return due;
+    }
+
+    // Then steal whatever other workers have left overdue
+    for (const auto& entry : entries_) {
+        if (entry->busy || entry->owner == index) {
+            continue;
+        }
+        const Clock::time_point steal_at = entry->deadline + kStealSlack;
+        if (steal_at <= now) {
+            if (!due || entry->deadline < due->deadline) {
+                due = entry.get();
+            }
+        } else {
+            next_wake = std::min(next_wake, steal_at);
+        }
+    }
+    return due;
+}
+
+void RenderPool::workerLoop(int index) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stopping_) {
+        const Clock::time_point now = Clock::now();
+        Clock::time_point next_wake = now + std::chrono::milliseconds(100);
+
+        Entry* entry = claimDueEntry(index, now, next_wake);
+        if (!entry) {
+            wake_.wait_until(lock, next_wake);
+            continue;
+        }
+
+        entry->busy = true;
+        if (entry->owner != index) {
+            stolen_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (now - entry->deadline >= entry->period) {
+            late_.fetch_add(1, std::memory_order_relaxed);
+        }
+        InferencePipeline* pipeline = entry->pipeline;
+        const int interval_ms = entry->interval_ms;
+
+        // Render without the lock so other workers keep scheduling
+        lock.unlock();
+        const int hops = pipeline->renderToWatermark(interval_ms);
+        lock.lock();
+
+        wakeups_.fetch_add(1, std::memory_order_relaxed);
+        hops_.fetch_add(static_cast<uint64_t>(hops), std::memory_order_relaxed);
+
+        // Absolute deadlines; after a stall, restart from now
+        entry->deadline += entry->period;
+        entry->deadline = std::max(entry->deadline, Clock::now());
+        entry->busy = false;
+
+        // remove() may be waiting for this entry
+        wake_.notify_all();
+    }
+}
+
+} // namespace ddsp
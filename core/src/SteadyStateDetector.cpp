@@ -0,0 +1,113 @@
+#include "SteadyStateDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace ddsp {
+
+namespace {
+
+float maxAbsDifference(const std::vector<float>& a, const std::vector<float>& b) {
+    float max_delta = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i) {
+        max_delta = std::max(max_delta, std::abs(a[i] - b[i]));
+    }
+    return max_delta;
+}
+
+} // namespace
+
+bool SteadyStateDetector::inputChanged(const AudioFeatures& input) const {
+    return std::abs(input.f0_norm - last_input_.f0_norm) > config_.input_epsilon ||
+           std::abs(input.loudness_norm - last_input_.loudness_norm) > config_.input_epsilon;
+}
+
+bool SteadyStateDetector::shouldSkip(const AudioFeatures& input) {
+    hops_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!has_previous_ || inputChanged(input)) {
+        converged_hops_ = 0;
+        skipped_in_row_ = 0;
+        return false;
+    }
+
+    if (converged_hops_ < config_.min_converged_hops) {
+        return false;
+    }
+
+    if (config_.max_skipped_hops > 0 && skipped_in_row_ >= config_.max_skipped_hops) {
+        skipped_in_row_ = 0;
+        return false;
+    }
+
+    ++skipped_in_row_;
+    skipped_hops_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void SteadyStateDetector::update(const IControlModel& model, const AudioFeatures& input,
+                                 const SynthesisControls& output) {
+    const size_t state_size = model.stateSize();
+    if (current_state_.size() != state_size) {
+        current_state_.assign(state_size, 0.0f);
+        previous_state_.assign(state_size, 0.0f);
+        has_previous_ = false;
+    }
+    model.getState(current_state_.data(), state_size);
+
+    if (has_previous_ && !inputChanged(input)) {
+        float output_delta = std::abs(output.amplitude - previous_output_.amplitude);
+        output_delta = std::max(output_delta, maxAbsDifference(output.harmonics, previous_output_.harmonics));
+        output_delta = std::max(output_delta, maxAbsDifference(output.noiseAmps, previous_output_.noiseAmps));
+        const float state_delta = maxAbsDifference(current_state_, previous_state_);
+
+        if (state_delta < config_.state_threshold && output_delta < config_.output_threshold) {
+            ++converged_hops_;
+        } else {
+            converged_hops_ = 0;
+        }
+    } else {
+        converged_hops_ = 0;
+    }
+
+    previous_state_.swap(current_state_);
+    previous_output_.copyFrom(output);
+    last_input_ = input;
+    has_previous_ = true;
+}
+
+void SteadyStateDetector::prepare(const IControlModel& model) {
+    const ModelSignature& signature = model.getSignature();
+    current_state_.assign(model.stateSize(), 0.0f);
+    previous_state_.assign(model.stateSize(), 0.0f);
+    previous_output_.resize(signature.num_harmonics, signature.num_noise_amps);
+    has_previous_ = false;
+}
+
+void SteadyStateDetector::swapBuffers(SteadyStateDetector& other) {
+    previous_state_.swap(other.previous_state_);
+    current_state_.swap(other.current_state_);
+    std::swap(previous_output_, other.previous_output_);
+    invalidate();
+    other.invalidate();
+}
+
+void SteadyStateDetector::invalidate() {
+    has_previous_ = false;
+    converged_hops_ = 0;
+    skipped_in_row_ = 0;
+}
+
+SteadyStateDetector::Stats SteadyStateDetector::getStats() const {
+    Stats stats;
+    stats.hops = hops_.load(std::memory_order_relaxed);
+    stats.skipped_hops = skipped_hops_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SteadyStateDetector::resetStats() {
+    hops_.store(0, std::memory_order_relaxed);
+    skipped_hops_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace ddsp
@@ -0,0 +1,82 @@
+#include "StubControlModel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ddsp {
+
+namespace {
+    // State leak per frame: 0.5 converges to within 1e-6 in ~20 frames
+    constexpr float kStateLeak = 0.5f;
+    constexpr float kStateModulation = 0.1f;
+    constexpr float kNoiseFloor = 0.01f;
+}
+
+StubControlModel::StubControlModel()
+    : model_loaded_(false)
+{
+    state_.fill(0.0f);
+}
+
+bool StubControlModel::loadModel(const std::string& /*model_path*/, const ModelLoadOptions& /*options*/) {
+    model_loaded_ = true;
+    reset();
+    return true;
+}
+
+void StubControlModel::reset() {
+    state_.fill(0.0f);
+}
+
+bool StubControlModel::invoke(const AudioFeatures& input, SynthesisControls& output) {
+    if (!model_loaded_) {
+        return false;
+    }
+
+    // Each state unit relaxes towards a fixed nonlinear function of the inputs
+    const int state_size = static_cast<int>(state_.size());
+    for (int i = 0; i < state_size; ++i) {
+        float w = std::sin(0.37f * static_cast<float>(i + 1));
+        float v = std::cos(0.21f * static_cast<float>(i + 1));
+        float target = std::tanh(w * input.f0_norm + v * input.loudness_norm);
+        state_[i] = kStateLeak * state_[i] + (1.0f - kStateLeak) * target;
+    }
+
+    output.amplitude = input.loudness_norm * (1.0f + kStateModulation * state_[0]);
+
+    const int num_harmonics = static_cast<int>(output.harmonics.size());
+    for (int h = 0; h < num_harmonics; ++h) {
+        float modulation = 1.0f + kStateModulation * state_[h % state_size];
+        output.harmonics[h] = modulation / static_cast<float>(h + 1);
+    }
+
+    const int num_noise_amps = static_cast<int>(output.noiseAmps.size());
+    for (int n = 0; n < num_noise_amps; ++n) {
+        float modulation = 1.0f + kStateModulation * state_[(n + num_harmonics) % state_size];
+        output.noiseAmps[n] = kNoiseFloor * input.loudness_norm * modulation;
+    }
+
+    output.f0_hz = input.f0_hz;
+    return true;
+}
+
+size_t StubControlModel::stateSize() const {
+    return state_.size();
+}
+
+bool StubControlModel::getState(float* dst, size_t size) const {
+    if (size != state_.size()) {
+        return false;
+    }
+    std::copy(state_.begin(), state_.end(), dst);
+    return true;
+}
+
+bool StubControlModel::setState(const float* src, size_t size) {
+    if (size != state_.size()) {
+        return false;
+    }
+    std::copy(src, src + size, state_.begin());
+    return true;
+}
+
+} // namespace ddsp
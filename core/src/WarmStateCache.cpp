@@ -0,0 +1,87 @@
+#include "WarmStateCache.h"
+#include "InputUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace ddsp {
+
+bool WarmStateCache::build(IControlModel& model, const Config& config) {
+    states_.clear();
+    num_pitches_ = 0;
+    state_size_ = 0;
+
+    if (!model.isLoaded() || model.stateSize() == 0 ||
+        config.loudness_levels < 2 || config.pitch_step_semitones <= 0.0f ||
+        config.max_pitch_hz < config.min_pitch_hz) {
+        return false;
+    }
+
+    config_ = config;
+    state_size_ = model.stateSize();
+    min_midi_ = freqToMidiNote(config.min_pitch_hz);
+    const float max_midi = freqToMidiNote(config.max_pitch_hz);
+    num_pitches_ = static_cast<int>(std::floor((max_midi - min_midi_) / config.pitch_step_semitones)) + 1;
+
+    states_.assign(static_cast<size_t>(num_pitches_) * config.loudness_levels * state_size_, 0.0f);
+
+    SynthesisControls controls;
+    AudioFeatures features;
+    bool ok = true;
+
+    for (int p = 0; p < num_pitches_ && ok; ++p) {
+        const float midi = min_midi_ + p * config.pitch_step_semitones;
+        features.f0_hz = kFreqA4_Hz * std::pow(2.0f, (midi - kMidiNoteA4) / kSemitonesPerOctave);
+        features.f0_norm = normalizedPitch(features.f0_hz);
+
+        for (int l = 0; l < config.loudness_levels && ok; ++l) {
+            features.loudness_norm = static_cast<float>(l) / static_cast<float>(config.loudness_levels - 1);
+            features.loudness_db = denormalizeLoudness(features.loudness_norm);
+
+            // Cold start, as a new voice would
+            model.reset();
+            if (runToSteadyState(model, features, controls, config.max_warmup_hops,
+                                 config.convergence_threshold) < 0) {
+                ok = false;
+                break;
+            }
+            float* cell = states_.data() + (static_cast<size_t>(p) * config.loudness_levels + l) * state_size_;
+            model.getState(cell, state_size_);
+        }
+    }
+
+    model.reset();
+    model.resetTiming();
+
+    if (!ok) {
+        std::cerr << "Failed to build warm state cache" << std::endl;
+        states_.clear();
+        return false;
+    }
+
+    std::cout << "Warm state cache built (" << numEntries() << " states, "
+              << memoryBytes() / 1024 << " KB)" << std::endl;
+    return true;
+}
+
+int WarmStateCache::pitchIndex(float f0_hz) const {
+    const float midi = freqToMidiNote(std::max(f0_hz, kPitchRangeMin_Hz));
+    const int index = static_cast<int>(std::lround((midi - min_midi_) / config_.pitch_step_semitones));
+    return std::clamp(index, 0, num_pitches_ - 1);
+}
+
+int WarmStateCache::loudnessIndex(float loudness_norm) const {
+    const float scaled = std::clamp(loudness_norm, 0.0f, 1.0f) * (config_.loudness_levels - 1);
+    return static_cast<int>(std::lround(scaled));
+}
+
+const float* WarmStateCache::lookup(float f0_hz, float loudness_norm) const {
+    if (states_.empty()) {
+        return nullptr;
+    }
+    const size_t cell = static_cast<size_t>(pitchIndex(f0_hz)) * config_.loudness_levels
+                      + loudnessIndex(loudness_norm);
+    return states_.data() + cell * state_size_;
+}
+
+} // namespace ddsp
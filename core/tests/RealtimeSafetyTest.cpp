@@ -0,0 +1,122 @@
+// Render-path real-time safety: renders kHops hops with the Stub backend in
+// pull mode and in pipelined timer mode, with control events and model hot
+// swaps along the way, and fails unless RealtimeChecker saw no allocation,
+// free or mutex lock inside a render hop.
+//
+// Build with -DDDSP_BUILD_TESTS=ON -DDDSP_REALTIME_CHECKS=ON and run with
+// ctest; without DDSP_REALTIME_CHECKS nothing is intercepted and the test
+// passes trivially.
+
+#include "InferencePipeline.h"
+#include "RealtimeChecker.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kHops = 10000;
+constexpr int kSwapEveryHops = 2000;
+constexpr double kSampleRate = 48000.0;
+constexpr auto kTimeout = std::chrono::seconds(120);
+
+void exerciseControls(ddsp::InferencePipeline& pipeline, int hop, int hop_size) {
+    if (hop % 7 == 0) {
+        pipeline.setControls(220.0f + static_cast<float>(hop % 24) * 10.0f, 0.6f);
+    }
+    if (hop % 11 == 0) {
+        const int64_t now = pipeline.getHostSamplePosition();
+        pipeline.pushControlEvent(ddsp::ControlEvent::controls(now + hop_size / 2, 330.0f, 0.7f));
+    }
+    if (hop % 97 == 0) {
+        pipeline.noteOn(440.0f, 0.8f);
+    }
+    if (hop > 0 && hop % kSwapEveryHops == 0) {
+        pipeline.loadModelAsync("", ddsp::ModelLoadOptions(), ddsp::ControlModelBackend::Stub, 4);
+    }
+}
+
+bool prepare(ddsp::InferencePipeline& pipeline, int block_size) {
+    pipeline.prepareToPlay(kSampleRate, block_size);
+    return pipeline.loadModel("", 1, ddsp::ControlModelBackend::Stub);
+}
+
+// getNextBlock() renders every hop on this thread
+bool runPullMode() {
+    ddsp::InferencePipeline pipeline;
+    const int hop_size = static_cast<int>(kSampleRate * ddsp::kModelHopSize / ddsp::kModelSampleRate_Hz);
+    if (!prepare(pipeline, hop_size)) {
+        return false;
+    }
+    pipeline.setPullRendering(true);
+
+    std::vector<float> block(static_cast<size_t>(hop_size));
+    for (int hop = 0; hop < kHops; ++hop) {
+        exerciseControls(pipeline, hop, hop_size);
+        pipeline.getNextBlock(block.data(), hop_size);
+    }
+    return true;
+}
+
+// Inference and synthesis threads, consumed as fast as they render
+bool runPipelinedTimerMode() {
+    ddsp::InferencePipeline pipeline;
+    const int hop_size = static_cast<int>(kSampleRate * ddsp::kModelHopSize / ddsp::kModelSampleRate_Hz);
+    if (!prepare(pipeline, hop_size)) {
+        return false;
+    }
+    pipeline.setPipelinedRendering(true);
+    pipeline.startTimer(1);
+
+    std::vector<float> block(static_cast<size_t>(hop_size));
+    const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+    int hop = 0;
+    while (hop < kHops) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            std::cerr << "Pipelined mode rendered only " << hop << " hops" << std::endl;
+            pipeline.stopTimer();
+            return false;
+        }
+        if (pipeline.getNumReadySamples() < hop_size) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            continue;
+        }
+        exerciseControls(pipeline, hop, hop_size);
+        pipeline.getNextBlock(block.data(), hop_size);
+        ++hop;
+    }
+    pipeline.stopTimer();
+    return true;
+}
+
+} // namespace
+
+int main() {
+    if (!ddsp::RealtimeChecker::isAvailable()) {
+        std::printf("RealtimeChecker interception unavailable (configure with DDSP_REALTIME_CHECKS=ON)\n");
+    }
+
+    ddsp::RealtimeChecker::setEnabled(true);
+
+    const std::pair<const char*, bool (*)()> modes[] = {
+        {"pull", runPullMode},
+        {"pipelined timer", runPipelinedTimerMode},
+    };
+
+    int failures = 0;
+    for (const auto& [name, run] : modes) {
+        ddsp::RealtimeChecker::reset();
+        const bool rendered = run();
+        const uint64_t violations = ddsp::RealtimeChecker::getViolationCount();
+        std::printf("%-16s %d hops, %llu violations\n", name, kHops, static_cast<unsigned long long>(violations));
+        if (!rendered || violations != 0) {
+            ddsp::RealtimeChecker::report(std::cerr);
+            ++failures;
+        }
+    }
+
+    ddsp::RealtimeChecker::setEnabled(false);
+    return failures == 0 ? 0 : 1;
+}
@@ -2,6 +2,7 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include "InferencePipeline.h"
+#include "OfflineRenderer.h"
 #include "MidiInputProcessor.h"
 #include "DDSPTypes.h"
 #include <cmath>
@@ -13,6 +14,7 @@ public:
     DDSPProcessor(const std::string& model_path, double sample_rate, int block_size) {
         pipeline = std::make_unique<ddsp::InferencePipeline>();
         pipeline->prepareToPlay(sample_rate, block_size);
+        pipeline->setPullRendering(true);  // getNextBlock() renders on this thread
         
         if (!pipeline->loadModel(model_path)) {
             throw std::runtime_error("Failed to load model: " + model_path);
@@ -81,14 +83,7 @@ private:
     int block_size;
 
     py::bytes render() {
-        // Loop until we have enough data
-        // Note: getNumReadySamples is a helper we added to InferencePipeline
-        // We might need to trigger render multiple times if block_size > hop_size
-        while (pipeline->getNumReadySamples() < block_size) {
-            pipeline->triggerRender();
-        }
-        
-        // Read data
+        // Pull mode renders as many hops as the block needs
         pipeline->getNextBlock(temp_buffer.data(), block_size);
         
         // Convert to int16 for transmission/saving
@@ -108,7 +103,78 @@ private:
     }
 };
 
+// Whole-sequence rendering for bulk generation (no real-time loop)
+class DDSPOfflineRenderer {
+public:
+    DDSPOfflineRenderer(const std::string& model_path, double sample_rate) {
+        ddsp::OfflineRenderer::Options options;
+        options.sample_rate = sample_rate;
+        renderer.setOptions(options);
+
+        if (!renderer.loadModel(model_path)) {
+            throw std::runtime_error("Failed to load model: " + model_path);
+        }
+    }
+
+    // f0_hz, loudness_norm: one value per 20 ms frame
+    py::array_t<float> render(py::array_t<float, py::array::c_style | py::array::forcecast> f0_hz,
+                              py::array_t<float, py::array::c_style | py::array::forcecast> loudness_norm) {
+        if (f0_hz.size() != loudness_norm.size()) {
+            throw std::invalid_argument("f0_hz and loudness_norm must have the same length");
+        }
+
+        const int64_t num_frames = static_cast<int64_t>(f0_hz.size());
+        py::array_t<float> output(static_cast<py::ssize_t>(renderer.getNumOutputSamples(num_frames)));
+        {
+            py::gil_scoped_release release;
+            if (renderer.render(f0_hz.data(), loudness_norm.data(), num_frames, output.mutable_data()) < 0) {
+                throw std::runtime_error("Offline render failed");
+            }
+        }
+        return output;
+    }
+
+    // Long sequences: chunks on num_threads cores (0 = all), warmup_frames of overlap each
+    py::array_t<float> render_parallel(py::array_t<float, py::array::c_style | py::array::forcecast> f0_hz,
+                                       py::array_t<float, py::array::c_style | py::array::forcecast> loudness_norm,
+                                       int num_threads, int warmup_frames) {
+        if (f0_hz.size() != loudness_norm.size()) {
+            throw std::invalid_argument("f0_hz and loudness_norm must have the same length");
+        }
+
+        ddsp::OfflineRenderer::ParallelOptions options;
+        options.num_threads = num_threads;
+        options.warmup_frames = warmup_frames;
+
+        const int64_t num_frames = static_cast<int64_t>(f0_hz.size());
+        py::array_t<float> output(static_cast<py::ssize_t>(renderer.getNumOutputSamples(num_frames)));
+        {
+            py::gil_scoped_release release;
+            if (renderer.renderParallel(f0_hz.data(), loudness_norm.data(), num_frames,
+                                        output.mutable_data(), options) < 0) {
+                throw std::runtime_error("Offline render failed");
+            }
+        }
+        return output;
+    }
+
+    double realtime_factor() const {
+        return renderer.getStats().realtimeFactor();
+    }
+
+private:
+    ddsp::OfflineRenderer renderer;
+};
+
 PYBIND11_MODULE(ddsp_python, m) {
+    py::class_<DDSPOfflineRenderer>(m, "DDSPOfflineRenderer")
+        .def(py::init<const std::string&, double>())
+        .def("render", &DDSPOfflineRenderer::render)
+        .def("render_parallel", &DDSPOfflineRenderer::render_parallel,
+             py::arg("f0_hz"), py::arg("loudness_norm"), py::arg("num_threads") = 0, py::arg("warmup_frames") = 100)
+        .def_property_readonly("realtime_factor", &DDSPOfflineRenderer::realtime_factor);
+
+
     py::class_<DDSPProcessor>(m, "DDSPProcessor")
         .def(py::init<const std::string&, double, int>())
         .def("process", &DDSPProcessor::process)
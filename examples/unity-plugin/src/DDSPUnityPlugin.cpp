@@ -3,6 +3,10 @@
 #include <cmath>
 #include <algorithm>
 
+#ifdef DDSP_HAS_EMBEDDED_MODEL
+#include "ddsp_embedded_model.h"
+#endif
+
 namespace ddsp_unity {
 
 // ============================================================================
@@ -16,6 +20,9 @@ DDSPPluginState::DDSPPluginState(double sample_rate, int buffer_size)
     pipeline = std::make_unique<ddsp::InferencePipeline>();
     pipeline->prepareToPlay(sample_rate, buffer_size);
 
+    // All audio sources share one set of render workers
+    pipeline->setRenderPool(&ddsp::RenderPool::instance());
+
     // Allocate temp buffer
     temp_buffer.resize(buffer_size, 0.0f);
 
@@ -130,20 +137,22 @@ UNITY_AUDIODSP_RESULT UNITY_AUDIODSP_CALLBACK CreateCallback(UnityAudioEffectSta
 
     effect->data.state = new DDSPPluginState(sample_rate, buffer_size);
 
-    // Load model from environment variable or default path
+    // Load model from environment variable, the embedded model, or default path
     const char* model_path_env = std::getenv("DDSP_MODEL_PATH");
-    std::string model_path;
 
+    // Load on a background thread; the pipeline outputs silence until the
+    // model is swapped in, so Unity's create call never blocks on file I/O
     if (model_path_env && model_path_env[0] != '\0') {
-        // Use environment variable if set
-        model_path = model_path_env;
+        effect->data.state->pipeline->loadModelAsync(std::string(model_path_env));
     } else {
-        // Use default relative path (assumes models/ is at project root)
-        model_path = "../../models/Violin.tflite";
-    }
-
-    if (!model_path.empty()) {
-        effect->data.state->pipeline->loadModel(model_path);
+#ifdef DDSP_HAS_EMBEDDED_MODEL
+        // Compiled in by ddsp_embed_model(); no file I/O or path resolution
+        effect->data.state->pipeline->loadModelAsync(
+            ddsp::ModelBlob::wrap(ddsp_embedded_model, ddsp_embedded_model_size));
+#else
+        // Default relative path (assumes models/ is at project root)
+        effect->data.state->pipeline->loadModelAsync(std::string("../../models/Violin.tflite"));
+#endif
     }
 
     // Start background rendering
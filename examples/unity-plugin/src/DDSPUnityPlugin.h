@@ -2,6 +2,7 @@
 
 #include "AudioPluginInterface.h"
 #include "InferencePipeline.h"
+#include "RenderPool.h"
 #include "DDSPTypes.h"
 #include <memory>
 #include <cstring>